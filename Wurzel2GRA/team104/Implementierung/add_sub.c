@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "headers/add_sub.h"
+#include "headers/stats.h"
 
 /* 
   Helper-funtion to calculate a_shift and b_shift to adjust the positions of digits in bignums for addition or subtraction: 
@@ -13,7 +14,7 @@
   a_shift, b_shift = (0 - 2) - (2 - 3) = -1; -> a_decPlace > b_decPlace;
   a_shift = 1, b_shift = 0;
 */
-struct bignum add_sub_prepare(struct bignum * a, struct bignum * b, int * _b_shift) {
+struct bignum add_sub_prepare(struct bignum * a, struct bignum * b, int64_t * _b_shift) {
   struct bignum result;
   memset(&result, 0, sizeof (result));
 
@@ -31,7 +32,7 @@ struct bignum add_sub_prepare(struct bignum * a, struct bignum * b, int * _b_shi
   normalize(a);
   normalize(b);
 
-  int a_shift, b_shift = (b->exponent - b->mantissa_size) - (a->exponent - a->mantissa_size); 
+  int64_t a_shift, b_shift = (b->exponent - (int64_t)b->mantissa_size) - (a->exponent - (int64_t)a->mantissa_size); 
 
   /* a_decPlace <= b_decPlace */
   if (b_shift >= 0) {
@@ -53,9 +54,10 @@ struct bignum add_sub_prepare(struct bignum * a, struct bignum * b, int * _b_shi
   if (b->exponent > result.exponent)
     result.exponent = b->exponent;
   
-  result.deallocate = result.mantissa = calloc(result.mantissa_size + 1, sizeof(result.mantissa[0]));
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size + 1, sizeof(result.mantissa[0]));
   if (NULL == result.mantissa) {
-    fprintf (stderr, "add_sub_prepare: Memory allocation error!\nCould not allocate %d bytes\n", result.mantissa_size + 1);
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf (stderr, "add_sub_prepare: Memory allocation error!\nCould not allocate %" PRIu64 " bytes\n", result.mantissa_size + 1);
     return result;
   }
 
@@ -69,13 +71,13 @@ struct bignum add_sub_prepare(struct bignum * a, struct bignum * b, int * _b_shi
 
 /* Addition of two bignums with same sign */
 struct bignum add_same_sign(struct bignum a, struct bignum b) {
-  int i, b_shift;
+  int64_t i, b_shift;
   struct bignum result = add_sub_prepare(&a, &b, &b_shift);
   if (NULL == result.mantissa)
     return result;
 
   int32_t carry = 0;
-  for (i = 0; i < (int32_t)b.mantissa_size; ++i) {
+  for (i = 0; i < (int64_t)b.mantissa_size; ++i) {
     uint64_t digit = carry + result.mantissa[i + b_shift] + b.mantissa[i];
     carry = 0;
     if (digit >= result.base) {
@@ -92,7 +94,7 @@ struct bignum add_same_sign(struct bignum a, struct bignum b) {
       result.mantissa[i++] = 0;
     ++result.mantissa[i];
     
-    if (i == (int32_t)result.mantissa_size) {
+    if (i == (int64_t)result.mantissa_size) {
       ++result.mantissa_size;
       ++result.exponent;
     }
@@ -104,7 +106,7 @@ struct bignum add_same_sign(struct bignum a, struct bignum b) {
 
 /* Subtraction of two bignums with same sign */
 struct bignum sub_same_sign(struct bignum a, struct bignum b) {
-  int i, b_shift;
+  int64_t i, b_shift;
   struct bignum result = add_sub_prepare(&a, &b, &b_shift);
   if (NULL == result.mantissa)
     return result;
@@ -112,7 +114,7 @@ struct bignum sub_same_sign(struct bignum a, struct bignum b) {
   result.mantissa[result.mantissa_size] = 1; // Extra carry to borrow from in case a < b
 
   int32_t carry = 0;
-  for (i = 0; i < (int32_t)b.mantissa_size; ++i) {
+  for (i = 0; i < (int64_t)b.mantissa_size; ++i) {
     int64_t digit = carry + result.mantissa[i + b_shift] - b.mantissa[i];
     carry = 0;
     if (digit < 0) {
@@ -129,9 +131,9 @@ struct bignum sub_same_sign(struct bignum a, struct bignum b) {
     --result.mantissa[i];
     
     /* Number is negative -> convert from double compliment to normal representation in current base */
-    if (i == (int32_t)result.mantissa_size) {
+    if (i == (int64_t)result.mantissa_size) {
       carry = 0;
-      for (i = 0; i < (int32_t)result.mantissa_size; ++i) {
+      for (i = 0; i < (int64_t)result.mantissa_size; ++i) {
         int32_t digit = carry - result.mantissa[i];
         carry = 0;
         if (digit < 0) {
@@ -149,6 +151,7 @@ struct bignum sub_same_sign(struct bignum a, struct bignum b) {
 }
 
 struct bignum add_bignum(struct bignum a, struct bignum b) {
+  STATS_COUNT(OPERATION_ADD, a.mantissa_size + b.mantissa_size, a.mantissa_size + b.mantissa_size);
   if (a.negative == b.negative)
     return (add_same_sign(a, b)); 
   /* 
@@ -161,6 +164,7 @@ struct bignum add_bignum(struct bignum a, struct bignum b) {
 }
 
 struct bignum sub_bignum(struct bignum a, struct bignum b) {
+  STATS_COUNT(OPERATION_SUB, a.mantissa_size + b.mantissa_size, a.mantissa_size + b.mantissa_size);
   if (a.negative == b.negative)
     return (sub_same_sign(a, b));
   /* Same idea as in Addition */
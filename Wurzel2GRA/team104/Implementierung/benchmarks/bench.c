@@ -0,0 +1,556 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "../headers/bignum.h"
+#include "../headers/add_sub.h"
+#include "../headers/mul.h"
+#include "../headers/div.h"
+#include "../headers/sqrt2.h"
+#include "../tests/test_sqrt2.c"
+
+/*
+  Microbenchmarks for the single arithmetic operations, build with 'make bench'.
+  Every operation is measured on a grid of operand sizes with random digits. One sample is the average time of
+  'iterations' calls, where 'iterations' is chosen so that a sample takes at least MIN_SAMPLE_TIME seconds. Results
+  are freed inside the measurement loop, so memory usage does not grow with the number of iterations.
+  Reported are minimum, median and 90th percentile of the samples and the throughput in operand digits per second.
+
+  Example calls:
+    ./bench - all operations on the default grid in DECIMAL.
+    ./bench -b 16 -s 1000,2000,4000 --csv results.csv --json results.json
+    ./bench -o mul_bignum_karazuba -o div_bignum -s 100000
+    ./bench -t 10 -o sqrt2_V2 --csv baseline.csv - whole calculation for the sizes from tests/sqrt2_dec.txt.
+    ./bench -t 10 -o sqrt2_V2 --compare baseline.csv --threshold 5 - fails, if a size got more than 5% slower.
+
+  Baseline comparison: the CSV output of an earlier run serves as baseline. For every operation and size, that is 
+  present in both runs, the change of the median is reported. A change counts only if it is greater than the threshold
+  and greater than the noise of both runs, which is estimated as (p90 - min) / median of each run.
+  The program exits with EXIT_FAILURE, if any regression was found.
+*/
+
+#define MIN_SAMPLE_TIME (1e-3)
+#define MAX_SIZES (64)
+#define MAX_OPERATIONS (16)
+#define MAX_NAME_LENGTH (64)
+
+/* Operands of one measurement. All of them have 'digits' random digits */
+typedef struct bench_operands_t {
+  struct bignum a, b;
+  size_t digits;
+} bench_operands_t;
+
+/* Description of a measured operation. run() executes the operation once and deallocates its result */
+typedef struct bench_operation_t {
+  char * name;
+  size_t max_digits; // Larger sizes of the default grid are skipped to keep it in reasonable time for slow algorithms.
+  void (* run) (bench_operands_t * operands);
+} bench_operation_t;
+
+/* Result of the measurements of one operation for one size. Times are given in seconds per call */
+typedef struct bench_result_t {
+  char name[MAX_NAME_LENGTH];
+  size_t digits;
+  int samples;
+  long iterations;
+  double min, median, p90;
+  double throughput; // operand digits per second based on median.
+} bench_result_t;
+
+static void run_add(bench_operands_t * operands) {
+  struct bignum result = add_bignum(operands->a, operands->b);
+  free_bignum(&result);
+}
+
+static void run_sub(bench_operands_t * operands) {
+  struct bignum result = sub_bignum(operands->a, operands->b);
+  free_bignum(&result);
+}
+
+static void run_mul_V0(bench_operands_t * operands) {
+  struct bignum result = mul_bignum_V0(operands->a, operands->b);
+  free_bignum(&result);
+}
+
+static void run_mul_V1(bench_operands_t * operands) {
+  struct bignum result = mul_bignum_V1(operands->a, operands->b);
+  free_bignum(&result);
+}
+
+static void run_mul_karazuba(bench_operands_t * operands) {
+  struct bignum result = mul_bignum_karazuba(operands->a, operands->b);
+  free_bignum(&result);
+}
+
+static void run_div(bench_operands_t * operands) {
+  struct bignum result = div_bignum(operands->a, operands->b, operands->digits);
+  free_bignum(&result);
+}
+
+/* Binary Splitting with as many terms as the operand has digits */
+static void run_sum_pq(bench_operands_t * operands) {
+  pq_series_result_t result = sum_pq(&sqrt2_series, operands->a.base, 1, operands->digits + 1, 0);
+  free_bignum(&result.p);
+  free_bignum(&result.q);
+  free_bignum(&result.t);
+}
+
+static void run_build_string(bench_operands_t * operands) {
+  char * result = build_string(operands->a, operands->digits);
+  free(result);
+}
+
+/* Whole calculations like in test(), operands are only used for size and base */
+static void run_sqrt2(bench_operands_t * operands) {
+  struct bignum result = sqrt2(operands->digits, (operands->a.base == 10) ? DECIMAL : HEXADECIMAL);
+  free_bignum(&result);
+}
+
+static void run_sqrt2_V1(bench_operands_t * operands) {
+  struct bignum result = sqrt2_V1(operands->digits, (operands->a.base == 10) ? DECIMAL : HEXADECIMAL);
+  free_bignum(&result);
+}
+
+static void run_sqrt2_V2(bench_operands_t * operands) {
+  struct bignum result = sqrt2_V2(operands->digits, (operands->a.base == 10) ? DECIMAL : HEXADECIMAL);
+  free_bignum(&result);
+}
+
+static void run_sqrt2_V3(bench_operands_t * operands) {
+  struct bignum result = sqrt2_V3(operands->digits, (operands->a.base == 10) ? DECIMAL : HEXADECIMAL);
+  free_bignum(&result);
+}
+
+static bench_operation_t operations[] = {
+  { "add_bignum", SIZE_MAX, run_add },
+  { "sub_bignum", SIZE_MAX, run_sub },
+  { "mul_bignum_V0", 20000, run_mul_V0 },
+  { "mul_bignum_V1", 20000, run_mul_V1 },
+  { "mul_bignum_karazuba", 100000, run_mul_karazuba },
+  { "div_bignum", 20000, run_div },
+  { "sum_pq", 20000, run_sum_pq },
+  { "build_string", SIZE_MAX, run_build_string },
+  { "sqrt2_V0", 1000, run_sqrt2 },
+  { "sqrt2_V1", 1000, run_sqrt2_V1 },
+  { "sqrt2_V2", 10000, run_sqrt2_V2 },
+  { "sqrt2_V3", 10000, run_sqrt2_V3 },
+};
+
+/* Bignum with 'digits' random digits, the highest one is not zero. Value is in [0.1, 1) * base ^ exponent */
+static struct bignum random_bignum(size_t digits, uint32_t base, int64_t exponent) {
+  struct bignum x;
+  memset(&x, 0, sizeof(x));
+  x.deallocate = x.mantissa = bignum_calloc(digits, sizeof(x.mantissa[0]));
+  if (NULL == x.mantissa) {
+    fprintf(stderr, "Bench: Memory allocation error!\n" "%zu bytes could not be allocated\n", digits);
+    return x;
+  }
+
+  for (size_t i = 0; i < digits; ++i)
+    x.mantissa[i] = rand() % base;
+  x.mantissa[0] = 1 + rand() % (base - 1);
+  x.mantissa[digits - 1] = 1 + rand() % (base - 1);
+  x.mantissa_size = digits;
+  x.exponent = exponent;
+  x.base = base;
+  return x;
+}
+
+static double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+
+static int compare_double(const void * a, const void * b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* Measures one operation for one size */
+static bench_result_t measure(bench_operation_t * operation, bench_operands_t * operands, int samples) {
+  bench_result_t result;
+  memset(&result, 0, sizeof(result));
+  snprintf(result.name, sizeof(result.name), "%s", operation->name);
+  result.digits = operands->digits;
+  result.samples = samples;
+
+  /* Calibration: doubling the iterations until a sample takes long enough */
+  long iterations = 1;
+  while (true) {
+    double start = now();
+    for (long i = 0; i < iterations; ++i)
+      operation->run(operands);
+    if (now() - start >= MIN_SAMPLE_TIME)
+      break;
+    iterations <<= 1;
+  }
+  result.iterations = iterations;
+
+  double times[samples];
+  for (int k = 0; k < samples; ++k) {
+    double start = now();
+    for (long i = 0; i < iterations; ++i)
+      operation->run(operands);
+    times[k] = (now() - start) / iterations;
+  }
+
+  qsort(times, samples, sizeof(times[0]), compare_double);
+  result.min = times[0];
+  result.median = times[samples / 2];
+  result.p90 = times[(samples * 9) / 10 < samples ? (samples * 9) / 10 : samples - 1];
+  result.throughput = operands->digits / result.median;
+  return result;
+}
+
+static bool write_csv(char * filename, bench_result_t * results, int count, uint32_t base) {
+  FILE * file = fopen(filename, "w");
+  if (NULL == file) {
+    fprintf(stderr, "Bench: Error opening file %s for writing\n", filename);
+    return false;
+  }
+
+  fprintf(file, "operation,base,digits,samples,iterations,min,median,p90,digits_per_second\n");
+  for (int i = 0; i < count; ++i) {
+    fprintf(file, "%s,%u,%zu,%d,%ld,%.9e,%.9e,%.9e,%.6e\n", results[i].name, base, results[i].digits, results[i].samples,
+      results[i].iterations, results[i].min, results[i].median, results[i].p90, results[i].throughput);
+  }
+  fclose(file);
+  return true;
+}
+
+static bool write_json(char * filename, bench_result_t * results, int count, uint32_t base) {
+  FILE * file = fopen(filename, "w");
+  if (NULL == file) {
+    fprintf(stderr, "Bench: Error opening file %s for writing\n", filename);
+    return false;
+  }
+
+  fprintf(file, "{\n  \"base\": %u,\n  \"results\": [\n", base);
+  for (int i = 0; i < count; ++i) {
+    fprintf(file, "    { \"operation\": \"%s\", \"digits\": %zu, \"samples\": %d, \"iterations\": %ld, \"min\": %.9e, "
+      "\"median\": %.9e, \"p90\": %.9e, \"digits_per_second\": %.6e }%s\n", results[i].name, results[i].digits,
+      results[i].samples, results[i].iterations, results[i].min, results[i].median, results[i].p90, results[i].throughput,
+      (i + 1 < count) ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+  fclose(file);
+  return true;
+}
+
+/* Reads results from a CSV file written by write_csv. Returns number of results, -1 in case of errors */
+static int read_csv(char * filename, bench_result_t ** results, uint32_t * base) {
+  FILE * file = fopen(filename, "r");
+  if (NULL == file) {
+    fprintf(stderr, "Bench: Error opening baseline file %s\n", filename);
+    return -1;
+  }
+
+  int count = 0, capacity = 0;
+  char line[512];
+  *results = NULL;
+  if (!fgets(line, sizeof(line), file) || strncmp(line, "operation,", strlen("operation,"))) {
+    fprintf(stderr, "Bench: %s is not a CSV file written by ./bench --csv\n", filename);
+    fclose(file);
+    return -1;
+  }
+
+  while (fgets(line, sizeof(line), file)) {
+    if (count == capacity) {
+      capacity = capacity ? capacity << 1 : 64;
+      bench_result_t * tmp = realloc(*results, capacity * sizeof(tmp[0]));
+      if (NULL == tmp) {
+        fprintf(stderr, "Bench: Memory allocation error while reading %s\n", filename);
+        free(*results);
+        *results = NULL;
+        fclose(file);
+        return -1;
+      }
+      *results = tmp;
+    }
+
+    bench_result_t * result = &(*results)[count];
+    if (9 != sscanf(line, "%63[^,],%u,%zu,%d,%ld,%lf,%lf,%lf,%lf", result->name, base, &result->digits, &result->samples,
+        &result->iterations, &result->min, &result->median, &result->p90, &result->throughput)) {
+      fprintf(stderr, "Bench: Invalid line %d in %s\n", count + 2, filename);
+      free(*results);
+      *results = NULL;
+      fclose(file);
+      return -1;
+    }
+    ++count;
+  }
+  fclose(file);
+  return count;
+}
+
+/* Noise of a measurement in percent: spread of the samples relative to the median */
+static double noise(bench_result_t * result) {
+  return 100.0 * (result->p90 - result->min) / result->median;
+}
+
+/* 
+  Compares results with baseline results (see description on top of the file).
+  Returns false, if at least one slowdown is greater than threshold and noise.
+*/
+static bool compare_results(bench_result_t * results, int count, bench_result_t * baseline, int baseline_count, double threshold) {
+  bool regression = false;
+  printf("\n%-20s %10s %13s %13s %9s %9s  %s\n", "operation", "digits", "baseline [s]", "median [s]", "change", "noise", "verdict");
+  for (int i = 0; i < count; ++i) {
+    bench_result_t * old = NULL;
+    for (int j = 0; j < baseline_count; ++j) {
+      if ((baseline[j].digits == results[i].digits) && !strcmp(baseline[j].name, results[i].name)) {
+        old = &baseline[j];
+        break;
+      }
+    }
+    if (NULL == old)
+      continue;
+
+    /* Positive change means slowdown */
+    double change = 100.0 * (results[i].median - old->median) / old->median;
+    double allowed_noise = noise(old) + noise(&results[i]);
+    char * verdict = "unchanged";
+    if ((change > threshold) && (change > allowed_noise)) {
+      verdict = "REGRESSION";
+      regression = true;
+    } 
+    else if ((-change > threshold) && (-change > allowed_noise)) {
+      verdict = "faster";
+    }
+    
+    printf("%-20s %10zu %13.6e %13.6e %+8.1f%% %8.1f%%  %s\n", results[i].name, results[i].digits, old->median, results[i].median,
+      change, allowed_noise, verdict);
+  }
+
+  if (regression) 
+    fprintf(stderr, "Bench: Regression of more than %.1f%% detected!\n", threshold);
+  return !regression;
+}
+
+/* Parses comma separated list of sizes, e.g. "100,1000,10000" */
+static int parse_sizes(size_t * sizes, char * string) {
+  int count = 0;
+  for (char * token = strtok(string, ","); token != NULL; token = strtok(NULL, ",")) {
+    int size;
+    if (!parse_integer(&size, token) || size < 1) {
+      fprintf(stderr, "Bench: Invalid size \"%s\"\n", token);
+      return 0;
+    }
+    if (count == MAX_SIZES) {
+      fprintf(stderr, "Bench: Too many sizes, maximum is %d\n", MAX_SIZES);
+      return 0;
+    }
+    sizes[count++] = size;
+  }
+  return count;
+}
+
+static void print_help(void) {
+  printf("Usage: ./bench [options]\n\n");
+  printf("-b <Zahl>\tNumeral system base of the operands, 10 or 16. (Default: 10)\n\n");
+  printf("-s <Liste>\tComma separated list of operand sizes in digits. (Default: 100,1000,10000,100000)\n\n");
+  printf("-o <Name>\tOnly measure this operation, can be given several times. (Default: all operations)\n\n");
+  printf("-n <Zahl>\tNumber of samples per operation and size. (Default: 11)\n\n");
+  printf("--csv <Datei>\tWrites results as CSV.\n\n");
+  printf("--json <Datei>\tWrites results as JSON.\n\n");
+  printf("-t <Zahl>\tUses the sizes from tests/sqrt2_dec.txt (10) or tests/sqrt2_hex.txt (16) up to --max-digits and\n\t\tsets the base accordingly.\n\n");
+  printf("--max-digits <Zahl>\tLargest size taken from the test files. (Default: 100000)\n\n");
+  printf("--compare <Datei>\tCompares the results with a baseline written by --csv.\n\n");
+  printf("--threshold <Zahl>\tSlowdown in percent, that counts as regression, if it is also above noise. (Default: 10)\n\n");
+  printf("Operations:");
+  for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); ++i)
+    printf(" %s", operations[i].name);
+  printf("\n");
+}
+
+int main(int argc, char * argv[]) {
+  int base = 10;
+  int samples = 11;
+  size_t sizes[MAX_SIZES] = { 100, 1000, 10000, 100000 };
+  int size_count = 4;
+  bool capped_sizes = true;
+  int test_numeral_system = 0;
+  int max_digits = 100000;
+  char * baseline_filename = NULL;
+  int threshold = 10;
+  bench_operation_t * selected[MAX_OPERATIONS];
+  int selected_count = 0;
+  char * csv_filename = NULL;
+  char * json_filename = NULL;
+
+  static struct option longopts[] = {
+    { "help", no_argument, NULL, 'h' },
+    { "csv", required_argument, NULL, 'c' },
+    { "json", required_argument, NULL, 'j' },
+    { "max-digits", required_argument, NULL, 'm' },
+    { "compare", required_argument, NULL, 'C' },
+    { "threshold", required_argument, NULL, 'T' },
+    { NULL,          0,          NULL,  0  },
+  };
+
+  int ch;
+  while ((ch = getopt_long(argc, argv, "hb:s:o:n:t:", longopts, NULL)) != -1) {
+    switch (ch) {
+      case 'b':
+        if (!parse_integer(&base, optarg) || ((base != 10) && (base != 16))) {
+          fprintf(stderr, "Bench: Invalid base, must be 10 or 16\n");
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 's':
+        if (!(size_count = parse_sizes(sizes, optarg)))
+          return EXIT_FAILURE;
+        capped_sizes = false;
+        break;
+
+      case 't':
+        if (!parse_integer(&test_numeral_system, optarg) || ((test_numeral_system != 10) && (test_numeral_system != 16))) {
+          fprintf(stderr, "Bench: Invalid value for option t. Must be 10 for DECIMAL or 16 for HEXADECIMAL!\n");
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'm':
+        if (!parse_integer(&max_digits, optarg) || max_digits < 1) {
+          fprintf(stderr, "Bench: Invalid value for --max-digits\n");
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'C':
+        baseline_filename = optarg;
+        break;
+
+      case 'T':
+        if (!parse_integer(&threshold, optarg)) {
+          fprintf(stderr, "Bench: Invalid value for --threshold\n");
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'o':
+      {
+        size_t i;
+        for (i = 0; i < sizeof(operations) / sizeof(operations[0]); ++i)
+          if (0 == strcmp(operations[i].name, optarg))
+            break;
+        if (i == sizeof(operations) / sizeof(operations[0])) {
+          fprintf(stderr, "Bench: Unknown operation \"%s\", use -h for the list of operations\n", optarg);
+          return EXIT_FAILURE;
+        }
+        if (selected_count < MAX_OPERATIONS)
+          selected[selected_count++] = &operations[i];
+        break;
+      }
+
+      case 'n':
+        if (!parse_integer(&samples, optarg) || samples < 1) {
+          fprintf(stderr, "Bench: Invalid number of samples\n");
+          return EXIT_FAILURE;
+        }
+        break;
+
+      case 'c':
+        csv_filename = optarg;
+        break;
+
+      case 'j':
+        json_filename = optarg;
+        break;
+
+      case 'h':
+        print_help();
+        return EXIT_SUCCESS;
+
+      default:
+        fprintf(stderr, "Use -h for available command-line arguments\n");
+        return EXIT_FAILURE;
+    }
+  }
+
+  /* Sizes of the tests, measured with the same limits as the default grid */
+  if (test_numeral_system) {
+    struct test_data_t test_data = read_test_data((test_numeral_system == 10) ? "tests/sqrt2_dec.txt" : "tests/sqrt2_hex.txt");
+    if (0 == test_data.test_count)
+      return EXIT_FAILURE;
+
+    base = test_numeral_system;
+    size_count = 0;
+    for (int t = 0; (t < test_data.test_count) && (size_count < MAX_SIZES); ++t)
+      if (test_data.test_length[t] <= max_digits)
+        sizes[size_count++] = test_data.test_length[t];
+    cleanup_test_data(&test_data);
+    capped_sizes = true;
+  }
+
+  if (0 == selected_count) {
+    for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); ++i)
+      selected[selected_count++] = &operations[i];
+  }
+
+  bench_result_t * results = calloc(selected_count * size_count, sizeof(results[0]));
+  if (NULL == results) {
+    fprintf(stderr, "Bench: Memory allocation error!\n");
+    return EXIT_FAILURE;
+  }
+  int result_count = 0;
+
+  srand(42);
+  printf("%-20s %10s %10s %13s %13s %13s %15s\n", "operation", "digits", "iterations", "min [s]", "median [s]", "p90 [s]", "digits/s");
+  for (int s = 0; s < size_count; ++s) {
+    bench_operands_t operands;
+    operands.digits = sizes[s];
+    operands.a = random_bignum(sizes[s], base, sizes[s]);
+    operands.b = random_bignum(sizes[s], base, 1);
+    if ((NULL == operands.a.mantissa) || (NULL == operands.b.mantissa)) {
+      free_bignum(&operands.a);
+      free_bignum(&operands.b);
+      free(results);
+      return EXIT_FAILURE;
+    }
+
+    for (int o = 0; o < selected_count; ++o) {
+      if (capped_sizes && (sizes[s] > selected[o]->max_digits))
+        continue;
+      bench_result_t * result = &results[result_count++];
+      *result = measure(selected[o], &operands, samples);
+      printf("%-20s %10zu %10ld %13.6e %13.6e %13.6e %15.6e\n", result->name, result->digits, result->iterations,
+        result->min, result->median, result->p90, result->throughput);
+      fflush(stdout);
+    }
+    free_bignum(&operands.a);
+    free_bignum(&operands.b);
+  }
+
+  bool success = true;
+  if (csv_filename)
+    success &= write_csv(csv_filename, results, result_count, base);
+  if (json_filename)
+    success &= write_json(json_filename, results, result_count, base);
+
+  if (baseline_filename) {
+    bench_result_t * baseline = NULL;
+    uint32_t baseline_base = base;
+    int baseline_count = read_csv(baseline_filename, &baseline, &baseline_base);
+    if (baseline_count < 0) {
+      success = false;
+    } 
+    else if (baseline_count && (baseline_base != (uint32_t)base)) {
+      fprintf(stderr, "Bench: Baseline was measured in base %u, current run in base %d\n", baseline_base, base);
+      success = false;
+    } 
+    else {
+      success &= compare_results(results, result_count, baseline, baseline_count, threshold);
+    }
+    free(baseline);
+  }
+
+  free(results);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,8 +3,19 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 #include "headers/bignum.h"
+#include "headers/wurzel.h"
 
 /* Parser from string to an integer with error handling. Based on material from Arbeitsblatt 6 (Praktikums-Website) */
 bool parse_integer(int * result_int, char * string) {
@@ -39,6 +50,250 @@ bool parse_integer(int * result_int, char * string) {
   return true;
 }
 
+/* Parser for numbers of digits with error handling, up to BIGNUM_MAX_DIGITS */
+bool parse_digits(size_t * result_digits, char * string) {
+  char * endptr;
+  errno = 0;
+  unsigned long long result = strtoull(string, &endptr, 0);
+
+  if (endptr == string) {
+    fprintf(stderr, "\"%s\" could not be converted to number!\n", string);
+    return false;
+  }
+
+  while (isspace(*endptr))
+    ++endptr;
+
+  if (*endptr != '\0') {
+    fprintf(stderr, "Further characters after number: \"%s\"!\n", endptr);
+    return false;
+  }
+
+  if ((errno != 0) || (result > BIGNUM_MAX_DIGITS) || strchr(string, '-')) { // strtoull negates negative numbers
+    fprintf(stderr, "Following value out of range: %s\n" "Must be between 0 and %" PRIu64 "\n", string, BIGNUM_MAX_DIGITS);
+    return false;
+  }
+
+  *result_digits = result;
+  return true;
+}
+
+/* 
+  Parser for memory sizes like "512M" with error handling. Suffixes K, M and G stand for 2 ^ 10, 2 ^ 20 and 2 ^ 30 bytes.
+*/
+bool parse_memory_size(size_t * result_size, char * string) {
+  char * endptr;
+  errno = 0;
+  unsigned long long result = strtoull(string, &endptr, 0);
+
+  if ((endptr == string) || (string[0] == '-')) {
+    fprintf(stderr, "\"%s\" could not be converted to memory size!\n", string);
+    return false;
+  }
+
+  int shift = 0;
+  switch (toupper(*endptr)) {
+    case 'K': shift = 10; ++endptr; break;
+    case 'M': shift = 20; ++endptr; break;
+    case 'G': shift = 30; ++endptr; break;
+  }
+
+  if ((*endptr != '\0') || (errno != 0) || (result > (SIZE_MAX >> shift))) {
+    fprintf(stderr, "Invalid memory size: \"%s\"\n", string);
+    return false;
+  }
+
+  *result_size = (size_t)result << shift;
+  return true;
+}
+
+/* Parser for ranges of places like "1000:50" (start:length) with error handling. Start is counted from 1 */
+bool parse_range(uint64_t * start, uint64_t * length, char * string) {
+  char * endptr;
+  errno = 0;
+  unsigned long long result_start = strtoull(string, &endptr, 10);
+  if ((endptr == string) || (string[0] == '-') || (*endptr != ':') || (errno != 0) || (0 == result_start)) {
+    fprintf(stderr, "Invalid range: \"%s\", must be start:length with start > 0\n", string);
+    return false;
+  }
+
+  char * length_string = endptr + 1;
+  unsigned long long result_length = strtoull(length_string, &endptr, 10);
+  if ((endptr == length_string) || (length_string[0] == '-') || (*endptr != '\0') || (errno != 0) || 
+      (result_length > UINT64_MAX - result_start)) {
+    fprintf(stderr, "Invalid range: \"%s\", must be start:length with start > 0\n", string);
+    return false;
+  }
+
+  *start = result_start;
+  *length = result_length;
+  return true;
+}
+
+/*
+  Accounting layer for all memory of bignums: the size of every allocation and its context are stored in a header in 
+  front of the returned memory, so that current and peak usage of each context can be tracked. If an allocation would
+  exceed the memory limit of the context, it fails with an error message and so do all following allocations of the 
+  context, so that the calculation ends as early as possible. Counters are updated atomically, since the threads of a
+  context share them.
+  Every returned pointer is a multiple of BIGNUM_ALIGNMENT, the header is stored directly in front of it.
+*/
+typedef struct allocation_header_t {
+  size_t bytes;
+  size_t mapped; // Length of the mapping for large allocations, 0 for memory from calloc.
+  void * block; // Start of the memory from calloc or of the mapping.
+  wurzel_context_t * context;
+} allocation_header_t;
+
+/* Accounted size of the header incl. alignment, calloc gets one alignment more for the unaligned start of its memory */
+#define ALLOCATION_HEADER_SIZE (BIGNUM_ALIGNMENT)
+_Static_assert(sizeof(allocation_header_t) <= ALLOCATION_HEADER_SIZE, "Allocation header does not fit");
+
+/* Memory policies of mbind, see set_mempolicy(2). Called by syscall, so that libnuma is not needed */
+#define MEMORY_POLICY_BIND (2)
+#define MEMORY_POLICY_INTERLEAVE (3)
+
+static unsigned long online_nodes = 0; // Mask of online NUMA nodes, 0 if unknown.
+static pthread_once_t online_nodes_once = PTHREAD_ONCE_INIT;
+
+/* Reads the online NUMA nodes from a list like "0-1,3" */
+static void read_online_nodes(void) {
+  FILE * file = fopen("/sys/devices/system/node/online", "r");
+  if (NULL == file)
+    return;
+  unsigned int first, last;
+  int fields;
+  while ((fields = fscanf(file, "%u-%u", &first, &last)) >= 1) {
+    if (1 == fields)
+      last = first;
+    for (unsigned int node = first; (node <= last) && (node < 8 * sizeof(online_nodes)); ++node)
+      online_nodes |= 1ul << node;
+    if (fgetc(file) != ',')
+      break;
+  }
+  fclose(file);
+}
+
+/* Sets the NUMA policy of the context for the mapping, before any of its pages is touched. Failures leave the default */
+static void place_mapping(void * memory, size_t length, wurzel_context_t * context) {
+#ifdef SYS_mbind
+  if (NUMA_DEFAULT == context->numa_policy)
+    return;
+  pthread_once(&online_nodes_once, read_online_nodes);
+  unsigned long nodes = online_nodes;
+  int mode = MEMORY_POLICY_INTERLEAVE;
+  if (NUMA_BIND == context->numa_policy) {
+    nodes &= 1ul << (context->numa_node % (8 * sizeof(nodes)));
+    mode = MEMORY_POLICY_BIND;
+  }
+  if (nodes)
+    syscall(SYS_mbind, memory, length, mode, &nodes, 8 * sizeof(nodes), 0);
+#else
+  (void)memory; (void)length; (void)context;
+#endif
+}
+
+/*
+  Maps 'bytes' bytes for a large allocation, the length of the mapping is stored in 'mapped'. Anonymous mappings are
+  zero, so no page is touched here except the first one (by the header): every page is placed by the thread, that writes
+  it first, or by the NUMA policy of the context. With huge pages, the mapping is aligned to BIGNUM_HUGE_PAGE_SIZE, so
+  that the kernel can back it by transparent huge pages.
+*/
+static uint8_t * map_large(size_t bytes, wurzel_context_t * context, size_t * mapped) {
+  size_t length = (bytes + BIGNUM_HUGE_PAGE_SIZE - 1) & ~(BIGNUM_HUGE_PAGE_SIZE - 1);
+  void * memory = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (HUGE_PAGES_EXPLICIT == context->huge_pages)
+    memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+  if ((MAP_FAILED == memory) && (HUGE_PAGES_OFF != context->huge_pages)) {
+    /* Mapping with one huge page more, the unaligned parts at both ends are unmapped again */
+    uint8_t * raw = mmap(NULL, length + BIGNUM_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED != (void *)raw) {
+      uint8_t * aligned = (uint8_t *)(((uintptr_t)raw + BIGNUM_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(BIGNUM_HUGE_PAGE_SIZE - 1));
+      if (aligned > raw)
+        munmap(raw, aligned - raw);
+      if (raw + BIGNUM_HUGE_PAGE_SIZE > aligned)
+        munmap(aligned + length, raw + BIGNUM_HUGE_PAGE_SIZE - aligned);
+      memory = aligned;
+#ifdef MADV_HUGEPAGE
+      madvise(memory, length, MADV_HUGEPAGE);
+#endif
+    }
+  }
+
+  if (MAP_FAILED == memory) {
+    length = bytes;
+    memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == memory)
+      return NULL;
+  }
+
+  place_mapping(memory, length, context);
+  *mapped = length;
+  return memory;
+}
+
+bool bignum_memory_exhausted(void) {
+  return __atomic_load_n(&context_current()->memory_exhausted, __ATOMIC_RELAXED);
+}
+
+/* Works like calloc, memory has to be deallocated with bignum_free */
+void * bignum_calloc(size_t count, size_t size) {
+  wurzel_context_t * context = context_current();
+  if (__atomic_load_n(&context->memory_exhausted, __ATOMIC_RELAXED))
+    return NULL;
+
+  if ((size != 0) && (count > (SIZE_MAX - ALLOCATION_HEADER_SIZE - BIGNUM_HUGE_PAGE_SIZE) / size)) {
+    fprintf(stderr, "bignum_calloc: Size of %zu x %zu bytes overflows size_t!\n", count, size);
+    return NULL;
+  }
+  size_t bytes = count * size + ALLOCATION_HEADER_SIZE;
+
+  size_t current = __atomic_add_fetch(&context->memory_current, bytes, __ATOMIC_RELAXED);
+  if (context->memory_limit && (current > context->memory_limit)) {
+    __atomic_sub_fetch(&context->memory_current, bytes, __ATOMIC_RELAXED);
+    if (!__atomic_exchange_n(&context->memory_exhausted, true, __ATOMIC_RELAXED)) {
+      fprintf(stderr, "Memory limit of %zu bytes exceeded: %zu bytes are in use, %zu more bytes were requested!\n",
+        context->memory_limit, current - bytes, bytes);
+    }
+    return NULL;
+  }
+
+  /* calloc is faster than posix_memalign with memset for the many small bignums, the start is aligned in the block */
+  size_t mapped = 0;
+  uint8_t * memory = (bytes >= BIGNUM_LARGE_ALLOCATION) ? map_large(bytes, context, &mapped) : calloc(bytes + BIGNUM_ALIGNMENT, 1);
+  if (NULL == memory) {
+    __atomic_sub_fetch(&context->memory_current, bytes, __ATOMIC_RELAXED);
+    return NULL;
+  }
+
+  size_t peak = __atomic_load_n(&context->memory_peak, __ATOMIC_RELAXED);
+  while ((current > peak) && !__atomic_compare_exchange_n(&context->memory_peak, &peak, current, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+
+  uintptr_t start = ((uintptr_t)memory + sizeof(allocation_header_t) + BIGNUM_ALIGNMENT - 1) & ~(uintptr_t)(BIGNUM_ALIGNMENT - 1);
+  allocation_header_t header = { .bytes = bytes, .mapped = mapped, .block = memory, .context = context };
+  memcpy((uint8_t *)start - sizeof(header), &header, sizeof(header));
+  return (void *)start;
+}
+
+/* Deallocates memory from bignum_calloc. Works in any thread, the context is taken from the header */
+void bignum_free(void * pointer) {
+  if (NULL == pointer)
+    return;
+
+  allocation_header_t header;
+  memcpy(&header, (uint8_t *)pointer - sizeof(header), sizeof(header));
+  __atomic_sub_fetch(&header.context->memory_current, header.bytes, __ATOMIC_RELAXED);
+  if (header.mapped)
+    munmap(header.block, header.mapped);
+  else
+    free(header.block);
+}
+
 /* Parcer from uint64_t to a bignum for easier initilisation */
 struct bignum bignum_uint64(uint64_t value, uint64_t base) {
   struct bignum bignum_value;
@@ -48,9 +303,10 @@ struct bignum bignum_uint64(uint64_t value, uint64_t base) {
   for (bignum_value.mantissa_size = 1; tmp >= base; bignum_value.mantissa_size++)
     tmp /= base;
   
-  bignum_value.deallocate = bignum_value.mantissa = calloc(bignum_value.mantissa_size, sizeof(bignum_value.mantissa[0]));
+  bignum_value.deallocate = bignum_value.mantissa = bignum_calloc(bignum_value.mantissa_size, sizeof(bignum_value.mantissa[0]));
   if (NULL == bignum_value.mantissa) {
-    fprintf(stderr, "bignum_uint64: Memory allocation error!\n" "%d bytes could not be allocated\n", bignum_value.mantissa_size);
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "bignum_uint64: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", bignum_value.mantissa_size);
     return bignum_value;
   }
 
@@ -67,12 +323,163 @@ struct bignum bignum_uint64(uint64_t value, uint64_t base) {
   return bignum_value;
 }
 
-/* Builds string representation of bignum with 'digits' decimal places for the output */
-char * build_string(struct bignum x, int digits) {
-  int i;
+/* Characters of the digits 0 .. 35 */
+static const char digit_characters[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/* Strings with at least FORMAT_PARALLEL_DIGITS digits are formatted by all threads of the current context */
+#define FORMAT_PARALLEL_DIGITS (1 << 16)
+#define FORMAT_MAX_CHUNKS (64)
+
+/* Separators between the places after the point: a space after every 'group' places, a newline after every 'line' */
+typedef struct format_layout_t {
+  size_t group, line;
+} format_layout_t;
+
+/* Task of the thread pool for one chunk of digits in build_string */
+typedef struct format_task_t {
+  pool_task_t task;
   char * buffer;
-  uint32_t curr = 0;
+  const uint8_t * mantissa;
+  size_t top, count, place;
+  format_layout_t layout;
+} format_task_t;
+
+#ifdef __SSE2__
+/* 16 digits in reversed order as characters: digit + '0', plus 'A' - '0' - 10 for the digits from 10 on */
+static inline __m128i format_vector(__m128i digits) {
+#ifdef __SSSE3__
+  digits = _mm_shuffle_epi8(digits, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+#else
+  digits = _mm_or_si128(_mm_slli_epi16(digits, 8), _mm_srli_epi16(digits, 8));
+  digits = _mm_shufflelo_epi16(digits, _MM_SHUFFLE(0, 1, 2, 3));
+  digits = _mm_shufflehi_epi16(digits, _MM_SHUFFLE(0, 1, 2, 3));
+  digits = _mm_shuffle_epi32(digits, _MM_SHUFFLE(1, 0, 3, 2));
+#endif
+  __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+  return _mm_add_epi8(_mm_add_epi8(digits, _mm_set1_epi8('0')), letters);
+}
+#endif
+
+/* Writes 'count' digits as characters, starting with mantissa[top] and going down */
+static void format_chunk(char * buffer, const uint8_t * mantissa, size_t top, size_t count) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for ( ; i + 16 <= count; i += 16) {
+    __m128i digits = _mm_loadu_si128((const __m128i *)(mantissa + top - i - 15));
+    _mm_storeu_si128((__m128i *)(buffer + i), format_vector(digits));
+  }
+#endif
+  for ( ; i < count; ++i)
+    buffer[i] = digit_characters[mantissa[top - i]];
+}
+
+/* Number of separators in front of the place with index 'place' (counted from 0 after the point) */
+static size_t format_separators(format_layout_t layout, size_t place) {
+  size_t separators = 0;
+  if (layout.group)
+    separators += place / layout.group;
+  if (layout.line) {
+    separators += place / layout.line;
+    if (layout.group) {
+      size_t a = layout.group, b = layout.line;
+      while (b) {
+        size_t r = a % b;
+        a = b;
+        b = r;
+      }
+      separators -= place / (layout.group / a * layout.line); // A newline replaces the space of the same position
+    }
+  }
+  return separators;
+}
+
+/*
+  Writes 'count' places with the indices 'place' .. place + count - 1 to 'places', the first place after the point,
+  each with the separator in front of it. The digits are taken from mantissa[top] downwards, or zeros for NULL. Runs
+  between two separators are formatted in one go, so the layout costs one branch per group.
+*/
+static void format_places(char * places, format_layout_t layout, size_t place, const uint8_t * mantissa, size_t top, 
+    size_t count) {
+  char * output = places + place + ((place > 0) ? format_separators(layout, place - 1) : 0);
+  while (count > 0) {
+    if (place > 0) {
+      if (layout.line && (0 == place % layout.line))
+        *output++ = '\n';
+      else if (layout.group && (0 == place % layout.group))
+        *output++ = ' ';
+    }
+
+    size_t run = count;
+    if (layout.group && (layout.group - place % layout.group < run))
+      run = layout.group - place % layout.group;
+    if (layout.line && (layout.line - place % layout.line < run))
+      run = layout.line - place % layout.line;
+
+    if (mantissa) {
+      format_chunk(output, mantissa, top, run);
+      top -= run;
+    } else {
+      memset(output, '0', run);
+    }
+    output += run;
+    place += run;
+    count -= run;
+  }
+}
+
+static void format_run(void * argument) {
+  format_task_t * task = argument;
+  format_places(task->buffer, task->layout, task->place, task->mantissa, task->top, task->count);
+}
+
+/*
+  Writes 'count' digits of x, starting with the digit at index 'first' counted from the most significant digit, as the
+  places with the indices place .. place + count - 1 of 'buffer' (see format_places). Long ranges are split into one
+  chunk per thread of the current context, every chunk is written straight to its own offset of the buffer.
+*/
+static void format_digits(char * buffer, format_layout_t layout, size_t place, struct bignum x, size_t first, 
+    size_t count) {
+  size_t top = x.mantissa_size - 1 - first;
+  wurzel_context_t * context = context_current();
+  if ((NULL == context->pool) || (count < FORMAT_PARALLEL_DIGITS)) {
+    format_places(buffer, layout, place, x.mantissa, top, count);
+    return;
+  }
+
+  size_t chunks = (context->threads < FORMAT_MAX_CHUNKS) ? context->threads : FORMAT_MAX_CHUNKS;
+  size_t chunk = (count + chunks - 1) / chunks;
+  format_task_t tasks[FORMAT_MAX_CHUNKS];
+  size_t submitted = 0;
+  for (size_t offset = chunk; offset < count; offset += chunk) {
+    format_task_t * task = &tasks[submitted++];
+    task->buffer = buffer;
+    task->layout = layout;
+    task->place = place + offset;
+    task->mantissa = x.mantissa;
+    task->top = top - offset;
+    task->count = (count - offset < chunk) ? (count - offset) : chunk;
+    task->task.function = format_run;
+    task->task.argument = task;
+    pool_submit(context->pool, &task->task);
+  }
+
+  format_places(buffer, layout, place, x.mantissa, top, chunk);
+  for (size_t i = 0; i < submitted; ++i)
+    pool_wait(context->pool, &tasks[i].task);
+}
+
+/*
+  Builds string representation of bignum with exactly 'digits' places after the point for the output. The places are
+  separated by the group and line lengths of the current context.
+*/
+char * build_string(struct bignum x, size_t digits) {
+  char * buffer;
+  size_t curr = 0;
   size_t buffer_size = 1;
+  wurzel_context_t * context = context_current();
+  format_layout_t layout = { .group = context->group_digits, .line = context->line_digits };
+  format_layout_t integer = { .group = 0, .line = 0 };
+  size_t separators = (digits > 0) ? format_separators(layout, digits - 1) : 0;
   
   if (x.negative)
       ++buffer_size;
@@ -83,96 +490,53 @@ char * build_string(struct bignum x, int digits) {
     220 = 0.22 * 10 ^ 3 
     Output: mantisa[exp - mantissa]
   */
+  if (x.exponent <= 0)
+    buffer_size += digits + separators + sizeof("-0.");
+  else if (x.exponent < (int64_t)x.mantissa_size)
+    buffer_size += x.exponent + digits + separators + sizeof("-.");
+  else
+    buffer_size += x.exponent;
+
+  buffer = malloc(buffer_size * sizeof(char));
+  if (NULL == buffer) {
+    fprintf(stderr, "build_string: Memory allocation error!\n" "%zu chars could not be allocated\n", buffer_size);
+    return NULL;
+  }
+
+  if (x.negative) 
+    buffer[curr++] = '-';
 
   /* Case: exp <= 0 -> Output: 0.[-exp]mantissa */
   if (x.exponent <= 0) {
-      buffer_size += digits + sizeof("-0.");
-      buffer = malloc(buffer_size * sizeof(char));
-      if (NULL == buffer) {
-        fprintf(stderr, "build_string: Memory allocation error!\n" "%zu chars could not be allocated\n", buffer_size);
-        return NULL;
-      }
-
-      if (x.negative) 
-        buffer[curr++] = '-';
-      
       buffer[curr++] = '0';
       buffer[curr++] = '.';
 
-      int digits_to_add = digits;
-      if (digits_to_add > (-x.exponent)) 
-        digits_to_add = -x.exponent;
-          
-      for (i = 0; i < digits_to_add; ++i) {
-        buffer[curr++] = '0';
-      }
-      
-      digits -= digits_to_add;
-      digits_to_add = digits;
-      if (digits_to_add > (int)x.mantissa_size) 
-        digits_to_add = x.mantissa_size;
-
-      for (i = 0; i < digits_to_add; ++i) {
-        uint8_t digit = x.mantissa[x.mantissa_size - 1 - i];
-        if (digit < 10) {
-          buffer[curr++] = '0' + digit;
-        } else {
-          buffer[curr++] = 'A' + digit - 10;
-        }
-      }
-      for (i = digits_to_add; i < digits; ++i)
-        buffer[curr++] = '0';
+      size_t zeros = ((int64_t)digits > -(int64_t)x.exponent) ? (size_t)-(int64_t)x.exponent : (size_t)digits;
+      format_places(buffer + curr, layout, 0, NULL, 0, zeros);
+
+      size_t count = ((size_t)digits - zeros < x.mantissa_size) ? (size_t)digits - zeros : x.mantissa_size;
+      format_digits(buffer + curr, layout, zeros, x, 0, count);
+
+      format_places(buffer + curr, layout, zeros + count, NULL, 0, digits - zeros - count);
+      curr += digits + separators;
   } 
   /* Case: exp < mantissa -> Output: mant.issa, point_position = exp. */
-  else if (x.exponent < (int32_t)x.mantissa_size) {
-      buffer_size += x.mantissa_size + digits + sizeof("-.");
-      buffer = malloc(buffer_size * sizeof(char));
-      if (NULL == buffer) {
-        fprintf(stderr, "build_string: Memory allocation error!\n" "%zu could not be allocated\n", buffer_size);
-        return NULL;
-      }
+  else if (x.exponent < (int64_t)x.mantissa_size) {
+      format_digits(buffer + curr, integer, 0, x, 0, x.exponent);
+      curr += x.exponent;
+      buffer[curr++] = '.';
 
-      if (x.negative) 
-        buffer[curr++] = '-';
-      
-      uint32_t i;
-      for (i = 0; i < x.mantissa_size; ++i) {
-        if (x.exponent == (int32_t)i) 
-          buffer[curr++] = '.';
-        uint8_t digit = x.mantissa[x.mantissa_size - 1 - i];
-        if (digit < 10) {
-          buffer[curr++] = '0' + digit;
-        } else {
-          buffer[curr++] = 'A' + digit - 10;
-        }
-      }
-      for (i = 0; i < (uint32_t)digits; ++i)
-        buffer[curr++] = '0';
+      size_t count = (x.mantissa_size - x.exponent < digits) ? x.mantissa_size - x.exponent : digits;
+      format_digits(buffer + curr, layout, 0, x, x.exponent, count);
+      format_places(buffer + curr, layout, count, NULL, 0, digits - count);
+      curr += digits + separators;
   } 
   /* Output: mantisa[exp - mantissa] */
   else { 
-      buffer_size += x.exponent;
-
-      buffer = malloc(buffer_size * sizeof(char));
-      if (NULL == buffer) {
-        fprintf(stderr, "build_string: Memory allocation error!\n" "%zu could not be allocated\n", buffer_size);
-        return NULL;
-      }
-
-      if (x.negative) 
-        buffer[curr++] = '-';
-      
-      for (uint32_t i = 0; i < x.mantissa_size; ++i) {
-        uint8_t digit = x.mantissa[x.mantissa_size - 1 - i];
-        if (digit < 10) {
-          buffer[curr++] = '0' + digit;
-        } else {
-          buffer[curr++] = 'A' + digit - 10;
-        }
-      }
-      for (int i = 0; i < x.exponent - (int32_t)x.mantissa_size; ++i) {
-        buffer[curr++] = '0';
-      }
+      format_digits(buffer + curr, integer, 0, x, 0, x.mantissa_size);
+      curr += x.mantissa_size;
+      memset(buffer + curr, '0', x.exponent - x.mantissa_size);
+      curr += x.exponent - x.mantissa_size;
   }
   buffer[curr++] = 0;
   return buffer;
@@ -194,9 +558,27 @@ void normalize(struct bignum * x) {
     --x->mantissa_size;
 }
 
+/* Copy of x with at most 'mantissa_size' most significant digits of x, the rest is cut off */
+struct bignum copy_bignum(struct bignum x, size_t mantissa_size) {
+  struct bignum copy = x;
+  if (copy.mantissa_size > mantissa_size) 
+    copy.mantissa_size = mantissa_size;
+
+  copy.deallocate = copy.mantissa = bignum_calloc(copy.mantissa_size, sizeof(copy.mantissa[0]));
+  if (NULL == copy.mantissa) {
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "copy_bignum: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", copy.mantissa_size);
+    return copy;
+  }
+
+  memcpy(copy.mantissa, &x.mantissa[x.mantissa_size - copy.mantissa_size], copy.mantissa_size * sizeof(copy.mantissa[0]));
+  normalize(&copy);
+  return copy;
+}
+
 /* Deallocates memory used by bignum */
 void free_bignum(struct bignum * x) {
   if (x->deallocate) 
-    free(x->deallocate);
+    bignum_free(x->deallocate);
   x->deallocate = NULL;
 }
@@ -4,6 +4,8 @@
 #include <string.h>
 #include "headers/mul.h"
 #include "headers/div.h"
+#include "headers/fixed.h"
+#include "headers/stats.h"
 
 /* Makes the length of x.mantissa less or equal than mantissa_size */
 void truncate_mantissa(struct bignum * x, size_t mantissa_size) {
@@ -13,13 +15,374 @@ void truncate_mantissa(struct bignum * x, size_t mantissa_size) {
   }
 }
 
-/* Constant value 1 */
-static struct bignum one = {
-  .mantissa = (uint8_t[]){ 1 },
-  .mantissa_size = 1,
-  .exponent = 1,
-  .negative = false,
-};
+/*
+  Exact division of integers, see divmod_bignum. All helpers work on integers stored as arrays of digits, least 
+  significant digit first, with a fixed number of digits (leading zeros included).
+*/
+
+static uint8_t * digits_alloc(size_t count) {
+  uint8_t * digits = bignum_calloc(count ? count : 1, sizeof(digits[0]));
+  if ((NULL == digits) && !bignum_memory_exhausted()) // The exceeded memory limit was already reported
+    fprintf(stderr, "divmod_bignum: Memory allocation error!\n" "%zu bytes could not be allocated\n", count);
+  return digits;
+}
+
+static int digits_compare(const uint8_t * a, const uint8_t * b, size_t n) {
+  for (size_t i = n; i-- > 0; ) {
+    if (a[i] != b[i])
+      return (a[i] < b[i]) ? -1 : 1;
+  }
+  return 0;
+}
+
+/* r = r + b with n digits of r and m <= n digits of b, returns the carry */
+static uint32_t digits_add(uint8_t * r, size_t n, const uint8_t * b, size_t m, uint32_t base) {
+  uint32_t carry = 0;
+  for (size_t i = 0; (i < n) && (carry || (i < m)); ++i) {
+    uint32_t sum = r[i] + ((i < m) ? b[i] : 0) + carry;
+    carry = (sum >= base);
+    r[i] = carry ? sum - base : sum;
+  }
+  return carry;
+}
+
+/* r = r - b with n digits of r and m <= n digits of b, returns the borrow */
+static uint32_t digits_sub(uint8_t * r, size_t n, const uint8_t * b, size_t m, uint32_t base) {
+  uint32_t borrow = 0;
+  for (size_t i = 0; (i < n) && (borrow || (i < m)); ++i) {
+    uint32_t subtrahend = ((i < m) ? b[i] : 0) + borrow;
+    borrow = (r[i] < subtrahend);
+    r[i] = borrow ? r[i] + base - subtrahend : r[i] - subtrahend;
+  }
+  return borrow;
+}
+
+/* r = a * d for a single digit d, r and a have n digits, returns the carry */
+static uint32_t digits_mul_digit(uint8_t * r, const uint8_t * a, size_t n, uint32_t d, uint32_t base) {
+  uint32_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t product = a[i] * d + carry;
+    r[i] = product % base;
+    carry = product / base;
+  }
+  return carry;
+}
+
+/* a = a / d for a single digit d, that divides a */
+static void digits_div_digit(uint8_t * a, size_t n, uint32_t d, uint32_t base) {
+  uint32_t remainder = 0;
+  for (size_t i = n; i-- > 0; ) {
+    uint32_t value = remainder * base + a[i];
+    a[i] = value / d;
+    remainder = value % d;
+  }
+}
+
+/* r = a * b with na digits of a, nb digits of b and na + nb digits of r. Large products are calculated by Karazuba */
+static bool digits_mul(uint8_t * r, const uint8_t * a, size_t na, const uint8_t * b, size_t nb, uint32_t base) {
+  memset(r, 0, (na + nb) * sizeof(r[0]));
+  while ((na > 0) && (0 == a[na - 1]))
+    --na;
+  while ((nb > 0) && (0 == b[nb - 1]))
+    --nb;
+  if ((0 == na) || (0 == nb))
+    return true;
+
+  if ((na < DIV_BASECASE_DIGITS) || (nb < DIV_BASECASE_DIGITS)) {
+    for (size_t i = 0; i < na; ++i) {
+      uint32_t carry = 0;
+      for (size_t j = 0; j < nb; ++j) {
+        uint32_t value = r[i + j] + a[i] * b[j] + carry;
+        r[i + j] = value % base;
+        carry = value / base;
+      }
+      r[i + nb] = carry;
+    }
+    return true;
+  }
+
+  struct bignum x = { .mantissa = (uint8_t *)a, .mantissa_size = na, .exponent = na, .base = base };
+  struct bignum y = { .mantissa = (uint8_t *)b, .mantissa_size = nb, .exponent = nb, .base = base };
+  struct bignum product = mul_bignum_karazuba(x, y);
+  if (NULL == product.mantissa)
+    return false;
+  /* Digit i of the product has the weight exponent - mantissa_size + i */
+  memcpy(r + (product.exponent - product.mantissa_size), product.mantissa, product.mantissa_size * sizeof(r[0]));
+  free_bignum(&product);
+  return true;
+}
+
+/*
+  Long division (Knuth, TAOCP Vol. 2, Algorithm D): u with m + n + 1 digits is divided by v with n digits, whose most
+  significant digit is at least base / 2. q gets the m + 1 digits of the quotient, the lowest n digits of u are replaced
+  by the remainder, the other digits of u become 0.
+*/
+static void divide_basecase(uint8_t * q, uint8_t * u, size_t m, const uint8_t * v, size_t n, uint32_t base) {
+  uint32_t top = v[n - 1], next = (n > 1) ? v[n - 2] : 0;
+  for (size_t j = m + 1; j-- > 0; ) {
+    /* Estimate of the quotient digit from the top digits, it is at most 2 too large */
+    uint32_t numerator = u[j + n] * base + u[j + n - 1];
+    uint32_t qhat = numerator / top, rhat = numerator % top;
+    if (qhat >= base) {
+      qhat = base - 1;
+      rhat = numerator - qhat * top;
+    }
+    while ((n > 1) && (rhat < base) && (qhat * next > rhat * base + u[j + n - 2])) {
+      --qhat;
+      rhat += top;
+    }
+
+    /* u = u - qhat * v * base ^ j */
+    uint32_t carry = 0, borrow = 0;
+    for (size_t i = 0; i <= n; ++i) {
+      uint32_t product = ((i < n) ? qhat * v[i] : 0) + carry;
+      carry = product / base;
+      uint32_t subtrahend = product % base + borrow;
+      borrow = (u[i + j] < subtrahend);
+      u[i + j] = borrow ? u[i + j] + base - subtrahend : u[i + j] - subtrahend;
+    }
+
+    /* qhat was one too large: v is added back, the carry out of the top digit cancels the borrow */
+    if (borrow) {
+      --qhat;
+      digits_add(u + j, n + 1, v, n, base);
+    }
+    q[j] = qhat;
+  }
+}
+
+static bool divide_2n_1n(uint8_t * q, uint8_t * r, const uint8_t * a, const uint8_t * b, size_t n, uint32_t base);
+
+/*
+  Burnikel–Ziegler step: a with 3h digits is divided by b with 2h digits, a / base ^ h < b. q gets the h digits of the
+  quotient, r the 2h digits of the remainder. The quotient is estimated from the top digits of a and b and corrected
+  at most twice.
+*/
+static bool divide_3n_2n(uint8_t * q, uint8_t * r, const uint8_t * a, const uint8_t * b, size_t h, uint32_t base) {
+  const uint8_t * b1 = b + h;
+  uint8_t * x = digits_alloc(2 * h + 1); // r1 * base ^ h + a3 with the remainder r1 of the top digits.
+  uint8_t * d = digits_alloc(2 * h + 1); // q * b2.
+  uint8_t * extended = digits_alloc(2 * h + 1); // b with one more digit.
+  bool success = x && d && extended;
+
+  if (success) {
+    memcpy(x, a, h * sizeof(x[0]));
+    if (digits_compare(a + 2 * h, b1, h) < 0) {
+      success = divide_2n_1n(q, x + h, a + h, b1, h, base);
+    } else {
+      /* q = base ^ h - 1, r1 = a1a2 - q * b1 = a1a2 - b1 * base ^ h + b1 < 2 * b1 is calculated in d */
+      memset(q, base - 1, h * sizeof(q[0]));
+      memcpy(d, a + h, 2 * h * sizeof(d[0]));
+      digits_add(d, 2 * h + 1, b1, h, base);
+      digits_sub(d + h, h + 1, b1, h, base);
+      memcpy(x + h, d, (h + 1) * sizeof(x[0]));
+    }
+  }
+
+  if (success)
+    success = digits_mul(d, q, h, b, h, base);
+
+  if (success) {
+    d[2 * h] = 0;
+    memcpy(extended, b, 2 * h * sizeof(extended[0]));
+    extended[2 * h] = 0;
+    if (digits_compare(x, d, 2 * h + 1) >= 0) {
+      digits_sub(x, 2 * h + 1, d, 2 * h + 1, base);
+    } else {
+      /* The remainder is negative: q is decremented and b added, until the deficit d - x is covered */
+      digits_sub(d, 2 * h + 1, x, 2 * h + 1, base);
+      uint8_t one = 1;
+      while (true) {
+        digits_sub(q, h, &one, 1, base);
+        if (digits_compare(d, extended, 2 * h + 1) <= 0) {
+          memcpy(x, extended, (2 * h + 1) * sizeof(x[0]));
+          digits_sub(x, 2 * h + 1, d, 2 * h + 1, base);
+          break;
+        }
+        digits_sub(d, 2 * h + 1, extended, 2 * h + 1, base);
+      }
+    }
+    memcpy(r, x, 2 * h * sizeof(r[0]));
+  }
+
+  bignum_free(x);
+  bignum_free(d);
+  bignum_free(extended);
+  return success;
+}
+
+/*
+  Burnikel–Ziegler division: a with 2n digits is divided by b with n digits, a / base ^ n < b and the most significant
+  digit of b is at least base / 2. q gets the n digits of the quotient, r the n digits of the remainder. Small or odd
+  n are divided by the long division.
+*/
+static bool divide_2n_1n(uint8_t * q, uint8_t * r, const uint8_t * a, const uint8_t * b, size_t n, uint32_t base) {
+  if ((n & 1) || (n <= DIV_BASECASE_DIGITS)) {
+    uint8_t * u = digits_alloc(2 * n + 1);
+    uint8_t * quotient = digits_alloc(n + 1);
+    bool success = u && quotient;
+    if (success) {
+      memcpy(u, a, 2 * n * sizeof(u[0]));
+      divide_basecase(quotient, u, n, b, n, base);
+      memcpy(q, quotient, n * sizeof(q[0])); // The digit n of the quotient is 0, since a / base ^ n < b.
+      memcpy(r, u, n * sizeof(r[0]));
+    }
+    bignum_free(u);
+    bignum_free(quotient);
+    return success;
+  }
+
+  size_t h = n >> 1;
+  uint8_t * u = digits_alloc(3 * h);
+  bool success = (NULL != u);
+  if (success) {
+    success = divide_3n_2n(q + h, u + h, a + h, b, h, base);
+    memcpy(u, a, h * sizeof(u[0]));
+  }
+  if (success)
+    success = divide_3n_2n(q, r, u, b, h, base);
+  bignum_free(u);
+  return success;
+}
+
+/*
+  Integer division with quotient and remainder: a and b must be non-negative integers, b > 0. Returns the quotient
+  floor(a / b), the remainder a - floor(a / b) * b is stored in *remainder, if remainder is not NULL.
+  Divisors with at most DIV_BASECASE_DIGITS digits are divided by the long division, larger ones by the recursive 
+  division of Burnikel and Ziegler in blocks of n = j * 2 ^ k digits with j <= DIV_BASECASE_DIGITS, so that the
+  recursion ends in long divisions with at most DIV_BASECASE_DIGITS digits.
+*/
+struct bignum divmod_bignum(struct bignum a, struct bignum b, struct bignum * remainder) {
+  struct bignum quotient;
+  memset(&quotient, 0, sizeof(quotient));
+  if (remainder)
+    memset(remainder, 0, sizeof(*remainder));
+
+  /* Checking that a and b are valid bignums */
+  if ((NULL == a.mantissa) || (0 == a.mantissa_size) || (NULL == b.mantissa) || (0 == b.mantissa_size))
+    return quotient;
+
+  if (a.base != b.base)
+    return quotient;
+
+  normalize(&a);
+  normalize(&b);
+  if ((b.mantissa_size == 1) && (b.mantissa[0] == 0)) {
+    fprintf(stderr, "Division by 0!\n");
+    return quotient;
+  }
+  bool a_is_zero = (a.mantissa_size == 1) && (a.mantissa[0] == 0);
+  if (a.negative || b.negative || (!a_is_zero && (a.exponent < (int64_t)a.mantissa_size)) || (b.exponent < (int64_t)b.mantissa_size)) {
+    fprintf(stderr, "divmod_bignum: Only non-negative integers can be divided!\n");
+    return quotient;
+  }
+  STATS_COUNT(OPERATION_DIVMOD, a.mantissa_size + b.mantissa_size, a_is_zero ? 0 : a.exponent);
+
+  uint32_t base = b.base;
+  size_t s = b.exponent, length = a_is_zero ? 0 : a.exponent;
+
+  /* Block size n >= s of the divisor, the divisor is shifted by shift = n - s digits */
+  size_t n = s;
+  if (s > DIV_BASECASE_DIGITS) {
+    size_t m = 1;
+    while (m * DIV_BASECASE_DIGITS < s)
+      m <<= 1;
+    n = ((s + m - 1) / m) * m;
+  }
+  size_t shift = n - s;
+
+  /* 
+    Normalisation: a and b are multiplied by factor * base ^ shift, so that the most significant digit of the divisor
+    v is at least base / 2. The dividend u gets one digit more and is padded to whole blocks of n digits.
+  */
+  uint32_t factor = base / (b.mantissa[b.mantissa_size - 1] + 1);
+  size_t blocks = (length + shift + 1 + n - 1) / n;
+  if (blocks < 2)
+    blocks = 2;
+  uint8_t * v = digits_alloc(n);
+  uint8_t * u = digits_alloc((blocks + 1) * n + 1); // One block more, if the top block is not less than v.
+  uint8_t * q = digits_alloc((blocks + 1) * n);
+  uint8_t * r = digits_alloc(n);
+  bool success = v && u && q && r;
+
+  if (success) {
+    /* Digit i of a mantissa has the weight exponent - mantissa_size + i */
+    memcpy(v + shift + (b.exponent - b.mantissa_size), b.mantissa, b.mantissa_size * sizeof(v[0]));
+    digits_mul_digit(v + shift, v + shift, s, factor, base);
+    if (!a_is_zero) {
+      memcpy(u + shift + (a.exponent - a.mantissa_size), a.mantissa, a.mantissa_size * sizeof(u[0]));
+      u[shift + length] = digits_mul_digit(u + shift, u + shift, length, factor, base);
+    }
+
+    if (n == s) {
+      /* Long division of the whole dividend */
+      divide_basecase(q, u, blocks * n - n, v, n, base);
+      memcpy(r, u, n * sizeof(r[0]));
+    } else {
+      /* Every step divides 2n by n digits with a top half less than v, so the top block has to be less than v */
+      if (digits_compare(u + (blocks - 1) * n, v, n) >= 0)
+        ++blocks;
+      uint8_t * z = digits_alloc(2 * n);
+      success = (NULL != z);
+      if (success)
+        memcpy(z + n, u + (blocks - 1) * n, n * sizeof(z[0]));
+      for (size_t i = blocks - 1; success && (i-- > 0); ) {
+        memcpy(z, u + i * n, n * sizeof(z[0]));
+        success = divide_2n_1n(q + i * n, r, z, v, n, base);
+        memcpy(z + n, r, n * sizeof(z[0]));
+      }
+      bignum_free(z);
+    }
+  }
+
+  if (success) {
+    quotient.deallocate = quotient.mantissa = q;
+    quotient.mantissa_size = quotient.exponent = blocks * n;
+    quotient.base = base;
+    q = NULL;
+    normalize(&quotient);
+
+    if (remainder) {
+      /* The normalisation is reverted: the lowest shift digits are 0 and the rest is divided by factor */
+      digits_div_digit(r + shift, s, factor, base);
+      memmove(r, r + shift, s * sizeof(r[0]));
+      memset(r + s, 0, shift * sizeof(r[0]));
+      remainder->deallocate = remainder->mantissa = r;
+      remainder->mantissa_size = remainder->exponent = s;
+      remainder->base = base;
+      r = NULL;
+      normalize(remainder);
+    }
+  }
+
+  bignum_free(v);
+  bignum_free(u);
+  bignum_free(q);
+  bignum_free(r);
+  return quotient;
+}
+
+/*
+  Division a/b with n digit precision by divmod_bignum: the quotient of the mantissas is calculated with at least n
+  digits and truncated, so all its digits are exact.
+*/
+static struct bignum div_exact(struct bignum a, struct bignum b, size_t n) {
+  size_t shift = (n + b.mantissa_size > a.mantissa_size) ? n + b.mantissa_size - a.mantissa_size : 0;
+  struct bignum dividend = { .mantissa = a.mantissa, .mantissa_size = a.mantissa_size, .exponent = a.mantissa_size + shift, .base = a.base };
+  struct bignum divisor = { .mantissa = b.mantissa, .mantissa_size = b.mantissa_size, .exponent = b.mantissa_size, .base = b.base };
+
+  STATS_PHASE_BEGIN(PHASE_DIV_EXACT);
+  struct bignum result = divmod_bignum(dividend, divisor, NULL);
+  STATS_PHASE_END(PHASE_DIV_EXACT);
+  if (NULL == result.mantissa)
+    return result;
+
+  /* a / b = (dividend / divisor) * base ^ (a.exponent - b.exponent - shift) */
+  result.exponent += a.exponent - (int64_t)a.mantissa_size - (b.exponent - (int64_t)b.mantissa_size) - (int64_t)shift;
+  truncate_mantissa(&result, n);
+  result.negative = a.negative ^ b.negative;
+  return result;
+}
 
 /*
   Division a/b with n digit precision:
@@ -29,27 +392,48 @@ static struct bignum one = {
 struct bignum div_bignum(struct bignum a, struct bignum b, size_t n) {
   struct bignum reciprocal;
   memset(&reciprocal, 0, sizeof(reciprocal));
+  struct bignum result = div_bignum_reciprocal(a, b, n, &reciprocal);
+  free_bignum(&reciprocal);
+  return result;
+}
+
+/*
+  Division a/b with n digit precision like div_bignum, that starts the Newton–Raphson method with a known reciprocal.
+  *reciprocal is the reciprocal of b with exponent 0 (only the mantissa of b matters) from a previous division by a
+  close value, or has a NULL mantissa for the initial guess 1. It is replaced by the refined reciprocal with about n
+  correct digits, so that a following division by a value, that differs from b only after k places, starts with k 
+  correct places instead of 1. Divisors with at most exact_max_digits digits are divided exactly instead.
+*/
+static struct bignum divide(struct bignum a, struct bignum b, size_t n, struct bignum * reciprocal, size_t exact_max_digits) {
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
   
   /* Checking that a and b are valid bignums */
   if ((NULL == a.mantissa) || (0 == a.mantissa_size) || (NULL == b.mantissa) || (0 == b.mantissa_size))
-    return reciprocal;
+    return result;
 
   if (a.base != b.base)
-    return reciprocal;
+    return result;
 
   /* Precautions */
   normalize(&a);
   normalize(&b);
+  STATS_COUNT(OPERATION_DIV, a.mantissa_size + b.mantissa_size, n);
 
   if ((b.mantissa_size == 1) && (b.mantissa[0] == 0)) {
     fprintf(stderr, "Division by 0!\n");
-    return reciprocal;
+    return result;
   }
 
-  /* Initial guess = 1 */ 
-  reciprocal = bignum_uint64(1, b.base);
+  /* Small divisors are divided exactly, *reciprocal is left unchanged */
+  if (b.mantissa_size <= exact_max_digits)
+    return div_exact(a, b, n);
 
-  one.base = b.base;
+  /* Initial guess = 1, if no reciprocal is known */ 
+  if ((NULL == reciprocal->mantissa) || (reciprocal->base != b.base)) {
+    free_bignum(reciprocal);
+    *reciprocal = bignum_uint64(1, b.base);
+  }
   a.exponent -= b.exponent;
   b.exponent = 0;
 
@@ -57,40 +441,78 @@ struct bignum div_bignum(struct bignum a, struct bignum b, size_t n) {
     Calculates the next reciprocal:
     Target function: f(x) = 1/x - b.
     next_reciprocal = reciprocal * (2 - b * reciprocal) = reciprocal + (1 - b * reciprocal) * reciprocal.
+    b is in [1/base, 1) and the reciprocal in (1, base], so the loop runs on fixed-point numbers with 'fraction' places
+    after the point. b is only used with the places, that the current precision needs, instead of all its digits.
   */
+  size_t fraction = (2 * reciprocal->mantissa_size + 4 < n + 8) ? 2 * reciprocal->mantissa_size + 4 : n + 8;
+  fixed_t x = fixed_from_bignum(*reciprocal, 2, fraction);
+  fixed_t divisor, one;
+  divisor.digits = one.digits = NULL;
+  bool success = (NULL != x.digits);
+  free_bignum(reciprocal);
  
-  while (true) {
-    struct bignum b_mul_reciprocal = mul_bignum_karazuba(b, reciprocal);
-    struct bignum one_sub_b_mul_reciprocal = sub_bignum(one, b_mul_reciprocal);
-    struct bignum residual = mul_bignum_karazuba(reciprocal, one_sub_b_mul_reciprocal); // residual shows error of current approximation
-    struct bignum next_reciprocal = add_bignum(reciprocal, residual);
+  STATS_PHASE_BEGIN(PHASE_RECIPROCAL);
+  while (success) {
+    if ((NULL == divisor.digits) || (divisor.fraction != fraction + FIXED_GUARD_DIGITS)) {
+      free_fixed(&divisor);
+      free_fixed(&one);
+      divisor = fixed_from_bignum(b, 1, fraction + FIXED_GUARD_DIGITS);
+      one = fixed_uint64(1, 1, fraction + FIXED_GUARD_DIGITS, b.base);
+    }
+    fixed_t error = fixed_uint64(0, 1, fraction + FIXED_GUARD_DIGITS, b.base);
+    fixed_t residual = fixed_uint64(0, 2, fraction, b.base); // residual shows error of current approximation
+
+    success = mul_fixed(&error, divisor, x) && sub_fixed(&error, one, error) && mul_fixed(&residual, x, error) &&
+      add_fixed(&x, x, residual);
+    bool residual_is_zero = success && fixed_is_zero(residual);
+    int64_t residual_exponent = success ? fixed_exponent(residual) : 0;
     
     /* Memory deallocation of temporary results */
-    free_bignum(&b_mul_reciprocal);
-    free_bignum(&one_sub_b_mul_reciprocal);
-    free_bignum(&residual);
-    free_bignum(&reciprocal);
-
-    if (NULL == next_reciprocal.mantissa)
-      return next_reciprocal;
-    reciprocal = next_reciprocal;
+    free_fixed(&error);
+    free_fixed(&residual);
+    if (!success)
+      break;
 
     /* 
-      Error of the current step is around residual.exponent.
-      Let's ignore reciprocal positions with indices greater than -2 * residual.exponent + 4.
-      These positions don't affect correctness of answer, but speeds the calculations up.
+      The step squares the error, so the new reciprocal is correct to about -2 * residual_exponent - 1 places, if the
+      step was calculated with that many places. If that exceeds the required precision with a few guard digits, the
+      approximation is close enough -> stop. (Checking the error before the step instead costs one step at twice the 
+      length, with a warm start even two.)
     */
-    int truncate_length = 4 - (residual.exponent << 1);
-    
-    /* Truncating insignificant positions */
-    truncate_mantissa(&reciprocal, truncate_length);
-
-    if (-residual.exponent > (int32_t)n) // Approxomation is close enough to the required precision -> stop.
+    bool converged = residual_is_zero || (-2 * residual_exponent > (int64_t)n + 4);
+    if (converged && (fraction >= n + 4))
       break;
+
+    /* 
+      The next step doubles the correct places again, so it is calculated with 4 - 4 * residual_exponent places.
+      Positions beyond the required precision and a few guard digits are never needed.
+    */
+    int64_t length = converged ? (int64_t)n + 8 : 4 - (residual_exponent << 2);
+    fraction = (length > (int64_t)n + 8) ? n + 8 : (size_t)length;
+    success = resize_fixed(&x, fraction);
+  }
+  STATS_PHASE_END(PHASE_RECIPROCAL);
+  free_fixed(&divisor);
+  free_fixed(&one);
+  if (!success) {
+    free_fixed(&x);
+    return result;
   }
-  struct bignum result = mul_bignum_karazuba(a, reciprocal);
+  *reciprocal = fixed_to_bignum(&x);
+
+  STATS_PHASE_BEGIN(PHASE_DIV_MULTIPLY);
+  result = mul_bignum_karazuba(a, *reciprocal);
   truncate_mantissa(&result, n);
-  free_bignum(&reciprocal);
-  reciprocal.negative = a.negative ^ b.negative;
+  STATS_PHASE_END(PHASE_DIV_MULTIPLY);
   return result;
 }
+
+/* Division with the known reciprocal, see divide. Divisors up to DIV_EXACT_MAX_DIGITS digits are divided exactly */
+struct bignum div_bignum_reciprocal(struct bignum a, struct bignum b, size_t n, struct bignum * reciprocal) {
+  return divide(a, b, n, reciprocal, DIV_EXACT_MAX_DIGITS);
+}
+
+/* Division with the known reciprocal by the Newton–Raphson method for all divisors, used by the tests of small sizes */
+struct bignum div_bignum_newton(struct bignum a, struct bignum b, size_t n, struct bignum * reciprocal) {
+  return divide(a, b, n, reciprocal, 0);
+}
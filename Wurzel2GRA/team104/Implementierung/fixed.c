@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/fixed.h"
+#include "headers/mul.h"
+#include "headers/wurzel.h"
+
+/* Zero with 'integer' places in front of the point and 'fraction' after it */
+static fixed_t fixed_alloc(size_t integer, size_t fraction, uint32_t base) {
+  fixed_t x = { .digits = NULL, .size = integer + fraction, .fraction = fraction, .base = base, .negative = false };
+  x.digits = bignum_calloc(x.size, sizeof(x.digits[0]));
+  if ((NULL == x.digits) && !bignum_memory_exhausted()) // The exceeded memory limit was already reported
+    fprintf(stderr, "fixed: Memory allocation error!\n" "%zu bytes could not be allocated\n", x.size);
+  return x;
+}
+
+fixed_t fixed_uint64(uint64_t value, size_t integer, size_t fraction, uint32_t base) {
+  fixed_t x = fixed_alloc(integer, fraction, base);
+  for (size_t i = fraction; (NULL != x.digits) && (i < x.size); ++i) {
+    x.digits[i] = value % base;
+    value /= base;
+  }
+  if ((NULL != x.digits) && (0 != value)) {
+    fprintf(stderr, "fixed_uint64: %zu places in front of the point are too few!\n", integer);
+    free_fixed(&x);
+  }
+  return x;
+}
+
+/* Digits of x below the last place are cut off, digits above the first place are an error */
+fixed_t fixed_from_bignum(struct bignum x, size_t integer, size_t fraction) {
+  fixed_t result = { .digits = NULL, .size = integer + fraction, .fraction = fraction, .base = x.base };
+  if (NULL == x.mantissa)
+    return result;
+  result = fixed_alloc(integer, fraction, x.base);
+  if (NULL == result.digits)
+    return result;
+
+  /* Digit j of x has the weight j - mantissa_size + exponent, digit i of the result i - fraction */
+  int64_t offset = (int64_t)x.mantissa_size - x.exponent - (int64_t)fraction; // j = i + offset
+  int64_t first = (offset < 0) ? -offset : 0;
+  int64_t last = (int64_t)x.mantissa_size - offset;
+  if (last > (int64_t)result.size) {
+    for (int64_t j = result.size + offset; j < (int64_t)x.mantissa_size; ++j) {
+      if (x.mantissa[j]) {
+        fprintf(stderr, "fixed_from_bignum: %zu places in front of the point are too few!\n", integer);
+        free_fixed(&result);
+        return result;
+      }
+    }
+    last = result.size;
+  }
+  if (first < last)
+    memcpy(result.digits + first, x.mantissa + first + offset, last - first);
+  result.negative = x.negative && !fixed_is_zero(result);
+  return result;
+}
+
+struct bignum fixed_to_bignum(fixed_t * x) {
+  struct bignum result = fixed_view(*x);
+  result.deallocate = x->digits;
+  x->digits = NULL;
+  if (NULL != result.mantissa)
+    normalize(&result);
+  return result;
+}
+
+struct bignum fixed_view(fixed_t x) {
+  struct bignum view = {
+    .mantissa = x.digits,
+    .deallocate = NULL,
+    .mantissa_size = x.size,
+    .exponent = (int64_t)x.size - (int64_t)x.fraction,
+    .base = x.base,
+    .negative = x.negative,
+  };
+  return view;
+}
+
+/* Places below the new last place are cut off, new places are 0 */
+bool resize_fixed(fixed_t * x, size_t fraction) {
+  if (fraction == x->fraction)
+    return true;
+
+  fixed_t resized = fixed_alloc(x->size - x->fraction, fraction, x->base);
+  if (NULL == resized.digits) {
+    free_fixed(x);
+    return false;
+  }
+  if (fraction > x->fraction)
+    memcpy(resized.digits + (fraction - x->fraction), x->digits, x->size);
+  else
+    memcpy(resized.digits, x->digits + (x->fraction - fraction), resized.size);
+  resized.negative = x->negative && !fixed_is_zero(resized);
+  free_fixed(x);
+  *x = resized;
+  return true;
+}
+
+void free_fixed(fixed_t * x) {
+  bignum_free(x->digits);
+  x->digits = NULL;
+}
+
+static bool same_layout(fixed_t * result, fixed_t a, fixed_t b) {
+  if ((NULL == result->digits) || (NULL == a.digits) || (NULL == b.digits))
+    return false;
+  if ((a.size != b.size) || (a.size != result->size) || (a.fraction != b.fraction) || (a.fraction != result->fraction) ||
+      (a.base != b.base)) {
+    fprintf(stderr, "fixed: Operands of different layouts!\n");
+    return false;
+  }
+  return true;
+}
+
+/* a + b for equal layouts: magnitudes are added or the smaller one is subtracted from the larger one */
+bool add_fixed(fixed_t * result, fixed_t a, fixed_t b) {
+  if (!same_layout(result, a, b))
+    return false;
+  uint32_t base = a.base;
+
+  if (a.negative == b.negative) {
+    uint32_t carry = 0;
+    for (size_t i = 0; i < a.size; ++i) {
+      uint32_t digit = a.digits[i] + b.digits[i] + carry;
+      carry = (digit >= base);
+      result->digits[i] = carry ? digit - base : digit;
+    }
+    result->negative = a.negative;
+    if (carry) {
+      fprintf(stderr, "add_fixed: Overflow of the places in front of the point!\n");
+      return false;
+    }
+    return true;
+  }
+
+  /* Different signs: a is made the operand with the larger magnitude */
+  size_t i = a.size;
+  while ((i > 0) && (a.digits[i - 1] == b.digits[i - 1]))
+    --i;
+  if ((i > 0) && (a.digits[i - 1] < b.digits[i - 1])) {
+    fixed_t swap = a;
+    a = b;
+    b = swap;
+  }
+
+  uint32_t borrow = 0;
+  for (size_t j = 0; j < a.size; ++j) {
+    int32_t digit = (int32_t)a.digits[j] - b.digits[j] - borrow;
+    borrow = (digit < 0);
+    result->digits[j] = borrow ? digit + (int32_t)base : digit;
+  }
+  result->negative = a.negative && (i > 0);
+  return true;
+}
+
+bool sub_fixed(fixed_t * result, fixed_t a, fixed_t b) {
+  b.negative = !b.negative;
+  return add_fixed(result, a, b);
+}
+
+/*
+  a * b truncated to the layout of result. This is deliberately not a short product: the full product of the digits is 
+  calculated by mul_bignum_karazuba (which normalizes both operands) and only then the digits below the last place of 
+  the result are cut off, so the truncation saves no multiplication work. The result is exact up to the truncation.
+*/
+bool mul_fixed(fixed_t * result, fixed_t a, fixed_t b) {
+  if ((NULL == result->digits) || (NULL == a.digits) || (NULL == b.digits))
+    return false;
+
+  struct bignum av = fixed_view(a), bv = fixed_view(b);
+  av.exponent = av.mantissa_size;
+  bv.exponent = bv.mantissa_size;
+  struct bignum product = mul_bignum_karazuba(av, bv);
+  if (NULL == product.mantissa)
+    return false;
+
+  /* Digit i of the result has the weight i + shift in the integer product of the digits */
+  int64_t shift = (int64_t)(a.fraction + b.fraction) - (int64_t)result->fraction;
+  int64_t low = product.exponent - (int64_t)product.mantissa_size; // Weight of product.mantissa[0].
+  bool fits = true;
+  int64_t first_dropped = (int64_t)result->size + shift - low;
+  for (int64_t j = (first_dropped < 0) ? 0 : first_dropped; j < (int64_t)product.mantissa_size; ++j)
+    fits = fits && (0 == product.mantissa[j]);
+
+  for (size_t i = 0; i < result->size; ++i) {
+    int64_t j = (int64_t)i + shift - low;
+    result->digits[i] = ((j >= 0) && (j < (int64_t)product.mantissa_size)) ? product.mantissa[j] : 0;
+  }
+  result->negative = (a.negative ^ b.negative) && !fixed_is_zero(*result);
+  free_bignum(&product);
+
+  if (!fits)
+    fprintf(stderr, "mul_fixed: Overflow of the places in front of the point!\n");
+  return fits;
+}
+
+void half_fixed(fixed_t * x) {
+  uint32_t remainder = 0;
+  for (size_t i = x->size; i-- > 0; ) {
+    uint32_t value = remainder * x->base + x->digits[i];
+    x->digits[i] = value >> 1;
+    remainder = value & 1;
+  }
+  x->negative = x->negative && !fixed_is_zero(*x);
+}
+
+bool fixed_is_zero(fixed_t x) {
+  for (size_t i = 0; i < x.size; ++i) {
+    if (x.digits[i])
+      return false;
+  }
+  return true;
+}
+
+int64_t fixed_exponent(fixed_t x) {
+  size_t i = x.size;
+  while ((i > 1) && (0 == x.digits[i - 1]))
+    --i;
+  return (int64_t)i - (int64_t)x.fraction;
+}
@@ -3,6 +3,7 @@
 
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* 
   The format for storing numbers of any size: the integer part and the fixed point in the exponent position.
@@ -16,17 +17,55 @@
 struct bignum {
   uint8_t * mantissa; // array to store digits of value, Little Endian.
   void * deallocate; // pointer for memory deallocation.
-  uint32_t mantissa_size; // number of digits in bignum.
-  int32_t exponent; // point position within the number.
+  uint64_t mantissa_size; // number of digits in bignum.
+  int64_t exponent; // point position within the number.
   uint32_t base; // numerical system base of bignum.
   bool negative; // flag for representation of negative numbers.
 };
 
+/* 
+  Largest number of digits of a bignum. Sizes and exponents are 64 bits wide, the limit leaves room for the sums of 
+  sizes and exponents in products, so that they cannot overflow.
+*/
+#define BIGNUM_MAX_DIGITS ((uint64_t)1 << 60)
+
 /* Implemenations can be found in corresponding c-file */
 bool parse_integer(int * result_int, char * string); // Parser from string to an integer with error handling.
+bool parse_digits(size_t * result_digits, char * string); // Parser for numbers of digits up to BIGNUM_MAX_DIGITS.
+bool parse_memory_size(size_t * result_size, char * string); // Parser for memory sizes with suffixes K, M and G.
+bool parse_range(uint64_t * start, uint64_t * length, char * string); // Parser for ranges of places "start:length".
 struct bignum bignum_uint64(uint64_t value, uint64_t base); // Parcer from uint64_t to a bignum for easier initialization. 
-char * build_string(struct bignum x, int digits); // Builds string representation of bignum with 'digits' decimal places for output.
+char * build_string(struct bignum x, size_t digits); // Builds string representation of bignum with 'digits' decimal places for output.
 void normalize(struct bignum * result);  // Delets all leading and trailing zeroes for correct calculations.
+struct bignum copy_bignum(struct bignum x, size_t mantissa_size); // Copy of the 'mantissa_size' most significant digits.
 void free_bignum(struct bignum * x); // Deallocates memory used by bignum.
 
+/* Alignment of all mantissas from bignum_calloc in bytes (one cache line) */
+#define BIGNUM_ALIGNMENT (64)
+
+/* Allocations of at least BIGNUM_LARGE_ALLOCATION bytes are mapped directly and may use huge pages */
+#define BIGNUM_LARGE_ALLOCATION ((size_t)1 << 21)
+
+/* Size of a huge page on x86-64 */
+#define BIGNUM_HUGE_PAGE_SIZE ((size_t)1 << 21)
+
+/* Use of huge pages for large allocations (--huge-pages) */
+typedef enum {
+  HUGE_PAGES_OFF, // Normal pages only.
+  HUGE_PAGES_TRANSPARENT, // Aligned mappings with madvise, the kernel uses transparent huge pages if available.
+  HUGE_PAGES_EXPLICIT, // Reserved huge pages (MAP_HUGETLB), transparent huge pages if none are left.
+} huge_pages_t;
+
+/* Placement of large allocations on the NUMA nodes (--numa) */
+typedef enum {
+  NUMA_DEFAULT, // Pages are placed on the node of the thread, that touches them first.
+  NUMA_INTERLEAVE, // Pages are distributed over all online nodes.
+  NUMA_BIND, // Pages are placed on one node.
+} numa_policy_t;
+
+/* Accounting layer for memory of bignums in the current context, implementations can be found in bignum.c */
+void * bignum_calloc(size_t count, size_t size); // calloc with accounting, fails if the memory limit would be exceeded.
+void bignum_free(void * pointer); // Deallocates memory from bignum_calloc.
+bool bignum_memory_exhausted(void); // True, if the memory limit of the current context was exceeded.
+
 #endif
@@ -0,0 +1,43 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"
+
+/* Places below the working precision, that absorb the truncation errors of the fixed-point operations */
+#define FIXED_GUARD_DIGITS (2)
+
+/*
+  Fixed-point number for values of known magnitude, e.g. the approximations of Newton loops: 'size' digits (Little
+  Endian), of which the lowest 'fraction' are places after the point, value = (-1) ^ negative * digits * base ^ -fraction.
+  Numbers are neither normalized nor aligned, add_fixed and sub_fixed only take operands of the same layout and are
+  plain loops over the digits. The result of an operation is given by the caller and may be one of the operands.
+*/
+typedef struct fixed_t {
+  uint8_t * digits; // NULL in case of errors.
+  size_t size; // Number of digits: places in front of the point + fraction.
+  size_t fraction; // Number of places after the point.
+  uint32_t base;
+  bool negative;
+} fixed_t;
+
+/* Implemenations can be found in corresponding c-file */
+fixed_t fixed_uint64(uint64_t value, size_t integer, size_t fraction, uint32_t base); // value with the given layout.
+fixed_t fixed_from_bignum(struct bignum x, size_t integer, size_t fraction); // x truncated to the given layout.
+struct bignum fixed_to_bignum(fixed_t * x); // Normalized bignum, takes over the digits of x.
+struct bignum fixed_view(fixed_t x); // Bignum with the digits of x (not normalized, not to be freed).
+bool resize_fixed(fixed_t * x, size_t fraction); // Changes the number of places after the point.
+void free_fixed(fixed_t * x);
+
+bool add_fixed(fixed_t * result, fixed_t a, fixed_t b); // false, if the value does not fit the layout.
+bool sub_fixed(fixed_t * result, fixed_t a, fixed_t b);
+bool mul_fixed(fixed_t * result, fixed_t a, fixed_t b); // Full product, then truncated to the layout of result.
+void half_fixed(fixed_t * x); // x / 2, truncated.
+
+bool fixed_is_zero(fixed_t x);
+int64_t fixed_exponent(fixed_t x); // Exponent like in struct bignum: |x| in [base ^ (e - 1), base ^ e), x != 0.
+
+#endif
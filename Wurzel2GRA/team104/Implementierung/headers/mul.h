@@ -5,6 +5,9 @@
 #include "add_sub.h"
 
 /* Implemenations can be found in corresponding c-file */
+struct bignum mul_bignum_V0(struct bignum a, struct bignum b);
+struct bignum mul_bignum_V1(struct bignum a, struct bignum b);
 struct bignum mul_bignum_karazuba(struct bignum a, struct bignum b);
+struct bignum sqr_bignum_karazuba(struct bignum a);
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+struct wurzel_context_t;
+
+/* States of a task in the thread pool */
+typedef enum {
+  TASK_QUEUED,
+  TASK_RUNNING,
+  TASK_DONE,
+} pool_task_state_t;
+
+/* Task of the thread pool. Memory is owned by the caller, it has to stay valid until pool_wait returns */
+typedef struct pool_task_t {
+  void (* function) (void * argument);
+  void * argument;
+  pool_task_state_t state;
+  struct pool_task_t * next;
+} pool_task_t;
+
+/* 
+  Thread pool of a context. Workers run tasks with the context of the pool as current context.
+  Tasks form a fork-join pattern: pool_wait runs a task, that is still queued, in the waiting thread itself, so a 
+  task may submit and wait for further tasks without running out of workers.
+*/
+typedef struct thread_pool_t {
+  pthread_t * workers;
+  int worker_count;
+  pthread_mutex_t mutex;
+  pthread_cond_t task_available; // Signaled, when a task is queued or the pool shuts down.
+  pthread_cond_t task_done; // Signaled, when a task is finished.
+  pool_task_t * head, * tail; // Queue of tasks, that are not started yet.
+  bool shutdown;
+  struct wurzel_context_t * context;
+} thread_pool_t;
+
+/* Implemenations can be found in corresponding c-file */
+thread_pool_t * pool_create(struct wurzel_context_t * context, int worker_count); // NULL in case of errors.
+void pool_destroy(thread_pool_t * pool); // Waits for all workers and deallocates the pool.
+void pool_submit(thread_pool_t * pool, pool_task_t * task); // Queues a task.
+void pool_wait(thread_pool_t * pool, pool_task_t * task); // Runs the task, if not started yet, and waits for it.
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef RADIX_H
+#define RADIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"
+
+/* Largest numeral system for output, digits are 0-9 and A-Z */
+#define RADIX_MAX_BASE (36)
+
+/* Integers with at most RADIX_BASECASE_DIGITS digits are converted by Horner's method */
+#define RADIX_BASECASE_DIGITS (64)
+
+/* Implemenations can be found in corresponding c-file */
+struct bignum radix_convert(struct bignum x, size_t places, uint32_t base, size_t digits, bool * certain); // See radix.c.
+struct bignum radix_convert_integer(struct bignum x, uint32_t base); // Integer x in numeral system 'base'.
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Text file mapped into memory for comparisons, e.g. a reference file with the digits of the root of 2 */
+typedef struct reference_file_t {
+  const char * data; // Mapping of the whole file, NULL if not open.
+  size_t size; // Size of the file in bytes.
+} reference_file_t;
+
+/* Result of reference_compare */
+typedef struct reference_match_t {
+  uint64_t digits; // Equal digits (in front of and after the point) up to the first difference or the end of a text.
+  bool mismatch; // The texts differ at the next digit.
+  bool first_ended, second_ended; // The text has no digits after the equal ones.
+} reference_match_t;
+
+/* Implemenations can be found in corresponding c-file */
+bool reference_open(reference_file_t * file, const char * path); // Maps a text file, false if it can not be read.
+void reference_close(reference_file_t * file); // Unmaps the text file.
+reference_match_t reference_compare(const char * first, size_t first_size, const char * second, size_t second_size); // See reference.c.
+
+#endif
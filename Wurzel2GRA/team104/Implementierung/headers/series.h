@@ -0,0 +1,46 @@
+#ifndef SERIES_H
+#define SERIES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"
+
+/*
+  Series of the form S = sum_{k >= 1} a(k) * prod_{j <= k} p(j) / q(j), given by its leaf terms. All leaf terms have to
+  fit into uint64_t, a may be NULL for a(k) = 1. The sum of the first terms is T / Q, see sum_pq.
+*/
+typedef struct pq_series_t {
+  uint64_t (* p) (size_t k);
+  uint64_t (* q) (size_t k);
+  uint64_t (* a) (size_t k);
+} pq_series_t;
+
+/* 
+  Structure to store P(n1,n2), Q(n1, n2), T(n1, n2). All values are Integer, unless they were truncated.
+  error is an upper bound for the relative error of p, q and t in units of base ^ (1 - precision), see sum_pq.
+*/
+typedef struct pq_series_result_t {
+  struct bignum p, q, t;
+  uint64_t error;
+} pq_series_result_t;
+
+/* Number of series and numeral systems, whose Binary Splitting state can be kept by a context */
+#define SUM_PQ_STATES (4)
+
+/* Kept state of Binary Splitting: exact P, Q and T of the interval [1, to) of a series in a numeral system, see sum_series */
+typedef struct sum_pq_state_t {
+  const pq_series_t * series; // NULL, if the slot is free.
+  uint32_t base;
+  pq_series_result_t value;
+  size_t to; // 0, if there is no state.
+} sum_pq_state_t;
+
+/* Implementations can be found in corresponding c-file */
+pq_series_result_t sum_pq(const pq_series_t * series, uint32_t base, size_t from, size_t to, size_t precision); // Binary Splitting.
+pq_series_result_t sum_pq_merge(pq_series_result_t low, pq_series_result_t high, size_t precision, bool parallel); // Adjacent intervals.
+struct bignum sum_series(const pq_series_t * series, uint32_t base, size_t terms, size_t digits); // T / Q of [1, terms), see series.c.
+void sum_pq_state_clear(sum_pq_state_t * state); // Deallocates a kept state and frees its slot.
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdbool.h>
+
+#include "wurzel.h"
+
+/* Maximal length of a request line incl. newline */
+#define SERVER_LINE_LENGTH (256)
+
+/* Maximal number of simultaneous connections to the socket */
+#define SERVER_MAX_CONNECTIONS (64)
+
+/*
+  Server mode: requests are lines "<base> <digits> [<version>]" with base 10 or 16, the answer is a line with the root
+  of 2 with 'digits' places or a line starting with "ERROR". All requests, that arrive while a batch is calculated, form
+  the next batch. A batch is answered by one calculation per numeral system with the largest requested precision, the
+  result cache and Binary Splitting state of the context are kept between batches.
+*/
+
+/* Implemenations can be found in corresponding c-file */
+bool server_run(wurzel_context_t * context, const char * socket_path); // Unix socket or stdin/stdout for NULL.
+bool client_run(const char * socket_path); // Sends lines of stdin to the server and prints the answers.
+
+#endif
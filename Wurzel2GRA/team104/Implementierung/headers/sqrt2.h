@@ -4,12 +4,14 @@
 #include "bignum.h"
 #include "mul.h"
 #include "div.h"
+#include "series.h"
 
 /* Enum for Hauptimplementierung, Optimierung and alternative Implementierung respectively  */
 typedef enum {
   VERSION_0 = 0,
   VERSION_1 = 1,
   VERSION_2 = 2,
+  VERSION_3 = 3,
 } version_t;
 
 /* Enum for numeral system the root of two will be calculated */
@@ -18,20 +20,51 @@ typedef enum {
   HEXADECIMAL,
 } numeral_system_t;
 
+/* Maximal number of numeral systems for output in one run (-d, -h and --base) */
+#define MAX_OUTPUTS (16)
+
 /* Data structure to store values of options and arguments given in command-line. Default values are set in main.c */
 typedef struct config_t{
   version_t version; // Version of implementation.
   int iteration; // Number of iterations of the function call for Benchmarking, if -B is set.
-  int digits; // Number of binary decimal places to be printed.
+  size_t digits; // Number of binary decimal places to be printed.
   numeral_system_t numeral_system; // numeral system the root of two will be calculated
   bool show_help; // Flag for --help or -h.
   bool show_time; // // Flag to show results of time measurments.
   bool test; // Flag to run tests. 
   int test_numeral_system; // numeral system for testing, must be 10 or 16 only. 
+  bool truncate; // Flag for --truncate: truncated Binary Splitting in Hauptimplementierung and VERSION_1.
+  bool verify; // Flag for --verify: self-verification of the result.
+  bool check_mul; // Flag for --check-mul: every large product is checked with modular checksums.
+  bool stats; // Flag for --stats: report of the instrumentation.
+  bool perf_counters; // Flag for --perf-counters: hardware counters per phase in the report.
+  size_t max_memory; // Limit for memory of bignums in bytes (--max-memory), 0 means no limit.
+  int threads; // Number of threads for Binary Splitting (--threads), including the calling thread.
+  huge_pages_t huge_pages; // Huge pages for large bignums (--huge-pages).
+  numa_policy_t numa_policy; // Placement of large bignums on NUMA nodes (--numa).
+  int numa_node; // Node for --numa <Knoten>.
+  size_t group_digits, line_digits; // Arguments of --group and --line, 0 if not set.
+  bool range; // Flag for --range: query of places from a result file.
+  uint64_t range_start, range_length; // Places range_start .. range_start + range_length - 1 for --range.
+  char * file; // Result file for --range (--file), NULL for the default file of the numeral system.
+  char * reference; // Reference file, that the output is compared with (--reference), NULL if not set.
+  char * compare; // Output file, that is compared with the reference instead of calculating (--compare), NULL if not set.
+  bool server; // Flag for --server: server mode with requests on stdin or on the socket.
+  char * socket; // Unix socket of the server (--socket), NULL for stdin and stdout.
+  char * client; // Unix socket of a server, that requests from stdin are sent to (--client).
+  int64_t decimal_digits, hexadecimal_digits; // Arguments of -d and -h, -1 if not set.
+  int output_count; // Number of numeral systems for output, only used if --base is set.
+  uint32_t output_bases[MAX_OUTPUTS]; // Numeral systems for output in the order of output.
+  size_t output_digits[MAX_OUTPUTS]; // Places for each numeral system.
 } config_t;
 
+/* Series for the Hauptimplementierung and VERSION_1, see sqrt2.c */
+extern const pq_series_t sqrt2_series;
+
 /* Implementations can be found in corresponding c-file */
 struct bignum sqrt2(size_t s, numeral_system_t base); // Hauptimplementierung. (VERSION_0) 
 struct bignum sqrt2_V1(size_t s, numeral_system_t base); // Optimierung using Newton–Raphson. (VERSION_1) 
 struct bignum sqrt2_V2(size_t s, numeral_system_t base); // Alternative Implementierung with vectorized multiplication. (VERSION_2) 
+struct bignum sqrt2_V3(size_t s, numeral_system_t base); // Third order iteration without division. (VERSION_3)
+bool verify_sqrt2(struct bignum x, size_t digits); // Checks, that the first 'digits' places of x are the places of root of 2.
 #endif
@@ -0,0 +1,94 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdbool.h>
+
+/* Phases of the calculation, that are timed separately. Phases may be nested, e.g. PHASE_RECIPROCAL in PHASE_NEWTON */
+typedef enum {
+  PHASE_SUM_PQ, // Binary Splitting.
+  PHASE_RECIPROCAL, // Newton–Raphson iteration for the reciprocal in div_bignum.
+  PHASE_DIV_MULTIPLY, // Final multiplication with the reciprocal in div_bignum.
+  PHASE_NEWTON, // Newton–Raphson iteration of sqrt2_V2.
+  PHASE_FINAL_ADD, // 1 + T / Q.
+  PHASE_BUILD_STRING, // Conversion to a string.
+  PHASE_OUTPUT, // Printing of the result.
+  PHASE_VERIFY, // --verify.
+  PHASE_RADIX, // Conversion into other numeral systems (--base).
+  PHASE_DIV_EXACT, // Exact division of small divisors in div_bignum.
+  PHASE_HOUSEHOLDER, // Third order iteration of sqrt2_V3.
+  PHASE_COUNT,
+} stats_phase_t;
+
+/* Arithmetic routines, whose calls and operand digits are counted. Recursive calls are counted as well */
+typedef enum {
+  OPERATION_ADD,
+  OPERATION_SUB,
+  OPERATION_MUL_V0, // Schoolbook multiplication.
+  OPERATION_MUL_V1, // Vectorised schoolbook multiplication.
+  OPERATION_MUL_KARAZUBA,
+  OPERATION_SQR_KARAZUBA,
+  OPERATION_DIV,
+  OPERATION_SUM_PQ, // Nodes of Binary Splitting, number of terms is counted as digits.
+  OPERATION_DIVMOD, // Integer division, digits of the dividend are counted as work.
+  OPERATION_COUNT,
+} stats_operation_t;
+
+/* Counters of --perf-counters, read around every phase. Counters, that are not available, stay 0 */
+typedef enum {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES, // Last level cache.
+  PERF_BRANCH_MISSES,
+  PERF_PAGE_FAULTS, // Software counter, available without hardware counters as well.
+  PERF_COUNTER_COUNT,
+} perf_counter_t;
+
+/* Accumulated times of a phase. depth > 0 while the phase is running, only the outermost call is timed */
+typedef struct phase_stats_t {
+  double wall, cpu;
+  double wall_start, cpu_start;
+  uint64_t counters[PERF_COUNTER_COUNT], counters_start[PERF_COUNTER_COUNT];
+  uint64_t calls;
+  int depth;
+} phase_stats_t;
+
+/* Counters of an arithmetic routine. work is the number of digit products for multiplications, digits otherwise */
+typedef struct operation_stats_t {
+  uint64_t calls, digits, work;
+} operation_stats_t;
+
+/* 
+  Instrumentation of one context. Counters are updated atomically, since worker threads share the context.
+  Phases are only started and stopped by the thread, that called the entry point of the library.
+*/
+typedef struct stats_t {
+  phase_stats_t phases[PHASE_COUNT];
+  operation_stats_t operations[OPERATION_COUNT];
+  uint64_t digits; // Largest number of places calculated, for the counters per digit.
+} stats_t;
+
+/* 
+  Instrumentation is compiled in only with -DWURZEL_STATS (default in Makefile, disabled with 'make STATS=0').
+  Otherwise all macros expand to nothing and cost nothing. 
+*/
+#ifdef WURZEL_STATS
+#define STATS_COUNT(operation, digits, work) stats_count((operation), (digits), (work))
+#define STATS_PHASE_BEGIN(phase) stats_phase_begin(phase)
+#define STATS_PHASE_END(phase) stats_phase_end(phase)
+#else
+#define STATS_COUNT(operation, digits, work) ((void)0)
+#define STATS_PHASE_BEGIN(phase) ((void)0)
+#define STATS_PHASE_END(phase) ((void)0)
+#endif
+
+/* Implemenations can be found in corresponding c-file */
+void stats_count(stats_operation_t operation, uint64_t digits, uint64_t work); // Counts one call in the current context.
+void stats_phase_begin(stats_phase_t phase); // Starts wall and CPU timer of a phase in the current context.
+void stats_phase_end(stats_phase_t phase); // Stops wall and CPU timer of a phase in the current context.
+void stats_reset(stats_t * stats); // Sets all counters and timers to zero.
+bool stats_perf_open(void); // Opens the counters of --perf-counters for the whole process, before threads are created.
+void stats_report(stats_t * stats, FILE * file); // Prints the report for --stats.
+
+#endif
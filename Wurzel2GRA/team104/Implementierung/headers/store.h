@@ -0,0 +1,39 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"
+
+/* Identification of result files and version of their format */
+#define STORE_MAGIC "WURZEL2"
+#define STORE_FORMAT (1)
+
+/*
+  Compact result file: a header followed by the places after the point, two places per byte. The first place of a byte
+  is stored in its upper nibble. Numbers in the header are stored in the byte order of the machine.
+*/
+typedef struct store_header_t {
+  char magic[8]; // STORE_MAGIC, terminated with 0.
+  uint32_t format; // STORE_FORMAT.
+  uint32_t base; // 10 or 16.
+  uint64_t integer_part; // Value in front of the point.
+  uint64_t digits; // Number of places after the point.
+} store_header_t;
+
+/* Result file mapped into memory for range queries */
+typedef struct store_file_t {
+  const uint8_t * data; // Mapping of the whole file, NULL if not open.
+  size_t size; // Size of the mapping in bytes.
+  store_header_t header;
+} store_file_t;
+
+/* Implemenations can be found in corresponding c-file */
+bool store_write(const char * path, struct bignum x, uint64_t digits); // Writes the first 'digits' places of x.
+bool store_open(store_file_t * file, const char * path); // Maps a result file, false if it is missing or invalid.
+void store_close(store_file_t * file); // Unmaps the result file.
+bool store_read(store_file_t * file, uint64_t start, uint64_t length, char * buffer); // Places start .. start + length - 1.
+
+#endif
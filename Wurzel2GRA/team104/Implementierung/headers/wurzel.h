@@ -0,0 +1,78 @@
+#ifndef WURZEL_H
+#define WURZEL_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bignum.h"
+#include "sqrt2.h"
+#include "stats.h"
+#include "pool.h"
+#include "store.h"
+#include "radix.h"
+
+/* Entry of the result cache: the most precise root of 2 calculated so far in one numeral system */
+typedef struct wurzel_cache_entry_t {
+  struct bignum value; // NULL mantissa, if nothing was calculated yet.
+  size_t digits; // Number of correct places after the point.
+} wurzel_cache_entry_t;
+
+/*
+  Context of calculations (libwurzel): configuration, memory accounting, instrumentation and thread pool.
+  Every calculation works only with its own context, so several contexts can be used concurrently in one process.
+  A single context must not be used by two calculations at the same time.
+  Library functions make their context the current context of the calling thread (see context_enter), all internal
+  routines take configuration and allocator from the current context. Without context the default context is used.
+*/
+typedef struct wurzel_context_t {
+  /* Configuration, may be changed between calculations */
+  bool vectorised; // Vectorised schoolbook multiplication in Karazuba, always used by VERSION_1.
+  bool truncated_splitting; // Truncated Binary Splitting (--truncate).
+  bool checked_multiplication; // Checking products with modular checksums (--check-mul).
+  size_t memory_limit; // Limit for memory of bignums in bytes (--max-memory), 0 means no limit.
+  bool cache_results; // Result cache of wurzel_sqrt2, off by default, since repeated calls are not calculated again.
+  bool keep_splitting_state; // Binary Splitting states of the series are kept and extended by later calculations.
+  huge_pages_t huge_pages; // Huge pages for large bignums (--huge-pages), transparent by default.
+  numa_policy_t numa_policy; // Placement of large bignums on NUMA nodes (--numa).
+  int numa_node; // Node for NUMA_BIND.
+  size_t group_digits; // Places after the point per group in the output, separated by a space (--group), 0 for none.
+  size_t line_digits; // Places after the point per line in the output (--line), 0 for one line.
+
+  /* Memory accounting, see bignum_calloc in bignum.c. Updated atomically by all threads of the context */
+  size_t memory_current;
+  size_t memory_peak;
+  bool memory_exhausted;
+
+  /* Result cache, one entry per numeral system, see wurzel_sqrt2 */
+  wurzel_cache_entry_t cache[HEXADECIMAL + 1];
+  uint64_t cache_hits, cache_misses;
+  sum_pq_state_t splitting_state[SUM_PQ_STATES]; // Kept states of Binary Splitting per series and numeral system.
+
+  /* Instrumentation for --stats, see stats.c */
+  stats_t stats;
+
+  /* Thread pool for parallel Binary Splitting, NULL if the context is single-threaded */
+  thread_pool_t * pool;
+  int threads;
+} wurzel_context_t;
+
+/* Library API, implementations can be found in wurzel.c */
+wurzel_context_t * wurzel_context_create(int threads); // Context with 'threads' threads (incl. caller), NULL on errors.
+void wurzel_context_destroy(wurzel_context_t * context); // Stops the thread pool and deallocates the context.
+struct bignum wurzel_sqrt2(wurzel_context_t * context, size_t digits, numeral_system_t base, version_t version); // Root of 2.
+bool wurzel_verify(wurzel_context_t * context, struct bignum x, size_t digits); // See verify_sqrt2.
+char * wurzel_format(wurzel_context_t * context, struct bignum x, size_t digits); // String with exactly 'digits' places.
+bool wurzel_sqrt2_bases(wurzel_context_t * context, size_t count, const uint32_t * bases, const size_t * digits, 
+  version_t version, char ** results); // Root of 2 in several numeral systems 2 .. 36 from one calculation.
+char * wurzel_range(wurzel_context_t * context, const char * path, numeral_system_t base, version_t version, 
+  uint64_t start, uint64_t length); // Places start .. start + length - 1 from a result file, see store.h.
+void wurzel_cache_clear(wurzel_context_t * context); // Deallocates cached results and kept Binary Splitting states.
+void wurzel_report(wurzel_context_t * context, FILE * file); // Report of instrumentation and memory (--stats).
+
+/* Current context of the calling thread, used by all internal routines */
+wurzel_context_t * context_current(void); // Current context of the thread or the default context.
+wurzel_context_t * context_enter(wurzel_context_t * context); // Makes context current, returns the previous one.
+void context_leave(wurzel_context_t * previous); // Restores the context returned by context_enter.
+
+#endif
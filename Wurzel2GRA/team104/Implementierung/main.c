@@ -11,10 +11,34 @@
 #include "headers/div.h"
 #include "headers/mul.h"
 #include "headers/sqrt2.h"
+#include "headers/stats.h"
+#include "headers/wurzel.h"
+#include "headers/server.h"
+#include "headers/reference.h"
 #include "tests/test_sqrt2.c"
 
-/* Global variable for numeral_system */
-uint32_t base = 10;
+/* Identifiers of options without short form */
+enum {
+  OPTION_TRUNCATE = 0x100,
+  OPTION_VERIFY,
+  OPTION_CHECK_MUL,
+  OPTION_STATS,
+  OPTION_MAX_MEMORY,
+  OPTION_THREADS,
+  OPTION_RANGE,
+  OPTION_FILE,
+  OPTION_SERVER,
+  OPTION_SOCKET,
+  OPTION_CLIENT,
+  OPTION_BASE,
+  OPTION_HUGE_PAGES,
+  OPTION_NUMA,
+  OPTION_GROUP,
+  OPTION_LINE,
+  OPTION_PERF_COUNTERS,
+  OPTION_REFERENCE,
+  OPTION_COMPARE,
+};
 
 /* 
   Function to parse command-line arguments using getopt_long. Catches invalid arguments.
@@ -24,6 +48,25 @@ bool parse_options(config_t * config, int argc, char * argv[]) {
   int ch;
   static struct option longopts[] = {
     { "help", optional_argument, NULL, 'h' },
+    { "truncate", no_argument, NULL, OPTION_TRUNCATE },
+    { "verify", no_argument, NULL, OPTION_VERIFY },
+    { "check-mul", no_argument, NULL, OPTION_CHECK_MUL },
+    { "stats", no_argument, NULL, OPTION_STATS },
+    { "max-memory", required_argument, NULL, OPTION_MAX_MEMORY },
+    { "threads", required_argument, NULL, OPTION_THREADS },
+    { "range", required_argument, NULL, OPTION_RANGE },
+    { "file", required_argument, NULL, OPTION_FILE },
+    { "reference", required_argument, NULL, OPTION_REFERENCE },
+    { "compare", required_argument, NULL, OPTION_COMPARE },
+    { "server", no_argument, NULL, OPTION_SERVER },
+    { "socket", required_argument, NULL, OPTION_SOCKET },
+    { "client", required_argument, NULL, OPTION_CLIENT },
+    { "base", required_argument, NULL, OPTION_BASE },
+    { "huge-pages", required_argument, NULL, OPTION_HUGE_PAGES },
+    { "numa", required_argument, NULL, OPTION_NUMA },
+    { "group", required_argument, NULL, OPTION_GROUP },
+    { "line", required_argument, NULL, OPTION_LINE },
+    { "perf-counters", no_argument, NULL, OPTION_PERF_COUNTERS },
     { NULL,          0,          NULL,  0  },
   };
 
@@ -39,8 +82,8 @@ bool parse_options(config_t * config, int argc, char * argv[]) {
           return false;
         }
 
-        if ((version < VERSION_0) || (version > VERSION_2)) {
-          fprintf(stderr, "Invalid version: %d\n" "Valid versions: 0, 1, 2\n", version);
+        if ((version < VERSION_0) || (version > VERSION_3)) {
+          fprintf(stderr, "Invalid version: %d\n" "Valid versions: 0, 1, 2, 3\n", version);
           return false;
         }
 
@@ -66,11 +109,12 @@ bool parse_options(config_t * config, int argc, char * argv[]) {
 
       case 'h':
         if ((optarg != NULL) || ((optind < argc) && (argv[optind][0] != '-'))) {
-          int tmp;
-          if (!parse_integer(&tmp, optarg ? optarg : argv[optind])) {
+          size_t tmp;
+          if (!parse_digits(&tmp, optarg ? optarg : argv[optind])) {
             fprintf(stderr, "Something went wrong while parsing argument for option h.\nPlease use -h or --help for valid function call examples\n");
             return false;
           }
+          config->hexadecimal_digits = tmp;
           if (!flag_set) {
             config->numeral_system = HEXADECIMAL;
             config->digits = tmp;
@@ -82,11 +126,12 @@ bool parse_options(config_t * config, int argc, char * argv[]) {
         break;
       
       case 'd':
-        if (!parse_integer(&config->digits, optarg)) {
+        if (!parse_digits(&config->digits, optarg)) {
           fprintf(stderr, "Something went wrong while parsing argument for option d.\nPlease use -h or --help for valid function call examples\n");
           return false;
         }
         config->numeral_system = DECIMAL;
+        config->decimal_digits = config->digits;
         flag_set = true;
         break;
 
@@ -101,12 +146,185 @@ bool parse_options(config_t * config, int argc, char * argv[]) {
         }
         config->test = true;
         break;
+
+      case OPTION_TRUNCATE:
+        config->truncate = true;
+        break;
+
+      case OPTION_VERIFY:
+        config->verify = true;
+        break;
+
+      case OPTION_CHECK_MUL:
+        config->check_mul = true;
+        break;
+
+      case OPTION_STATS:
+        config->stats = true;
+        break;
+
+      case OPTION_PERF_COUNTERS:
+#ifndef WURZEL_STATS
+        fprintf(stderr, "Option --perf-counters is not available, statistics were disabled at compile time (make STATS=0)\n");
+        return false;
+#else
+        config->perf_counters = config->stats = true;
+        break;
+#endif
+
+      case OPTION_MAX_MEMORY:
+        if (!parse_memory_size(&config->max_memory, optarg) || (0 == config->max_memory)) {
+          fprintf(stderr, "Something went wrong while parsing argument for option --max-memory.\nPlease use -h or --help for valid function call examples\n");
+          return false;
+        }
+        break;
+
+      case OPTION_THREADS:
+        if (!parse_integer(&config->threads, optarg)) {
+          fprintf(stderr, "Something went wrong while parsing argument for option --threads.\nPlease use -h or --help for valid function call examples\n");
+          return false;
+        }
+        if (config->threads < 1) {
+          fprintf(stderr, "Invalid number of threads: %d.\n" "Must be at least 1\n", config->threads);
+          return false;
+        }
+        break;
+
+      case OPTION_RANGE:
+        if (!parse_range(&config->range_start, &config->range_length, optarg)) {
+          fprintf(stderr, "Something went wrong while parsing argument for option --range.\nPlease use -h or --help for valid function call examples\n");
+          return false;
+        }
+        config->range = true;
+        break;
+
+      case OPTION_FILE:
+        config->file = optarg;
+        break;
+
+      case OPTION_REFERENCE:
+        config->reference = optarg;
+        break;
+
+      case OPTION_COMPARE:
+        config->compare = optarg;
+        break;
+
+      case OPTION_SERVER:
+        config->server = true;
+        break;
+
+      case OPTION_SOCKET:
+        config->server = true;
+        config->socket = optarg;
+        break;
+
+      case OPTION_CLIENT:
+        config->client = optarg;
+        break;
+
+      case OPTION_BASE:
+      {
+        char * separator = strchr(optarg, ':');
+        int base;
+        size_t digits;
+        if (separator)
+          *separator = 0;
+        if ((NULL == separator) || !parse_integer(&base, optarg) || !parse_digits(&digits, separator + 1)) {
+          fprintf(stderr, "Something went wrong while parsing argument for option --base.\nPlease use -h or --help for valid function call examples\n");
+          return false;
+        }
+        if ((base < 2) || (base > RADIX_MAX_BASE) || (config->output_count == MAX_OUTPUTS - 2)) {
+          fprintf(stderr, "Invalid numeral system: %d.\n" "Must be between 2 and %d, at most %d numeral systems are allowed\n", base, RADIX_MAX_BASE, MAX_OUTPUTS - 2);
+          return false;
+        }
+        config->output_bases[config->output_count] = base;
+        config->output_digits[config->output_count++] = digits;
+        break;
+      }
+
+      case OPTION_HUGE_PAGES:
+        if (0 == strcmp(optarg, "off")) {
+          config->huge_pages = HUGE_PAGES_OFF;
+        } else if (0 == strcmp(optarg, "transparent")) {
+          config->huge_pages = HUGE_PAGES_TRANSPARENT;
+        } else if (0 == strcmp(optarg, "explicit")) {
+          config->huge_pages = HUGE_PAGES_EXPLICIT;
+        } else {
+          fprintf(stderr, "Invalid argument for option --huge-pages: %s.\n" "Must be off, transparent or explicit\n", optarg);
+          return false;
+        }
+        break;
+
+      case OPTION_NUMA:
+        if (0 == strcmp(optarg, "interleave")) {
+          config->numa_policy = NUMA_INTERLEAVE;
+        } else if (parse_integer(&config->numa_node, optarg) && (config->numa_node >= 0)) {
+          config->numa_policy = NUMA_BIND;
+        } else {
+          fprintf(stderr, "Invalid argument for option --numa: %s.\n" "Must be interleave or the number of a node\n", optarg);
+          return false;
+        }
+        break;
+
+      case OPTION_GROUP:
+      case OPTION_LINE:
+        if (!parse_digits((OPTION_GROUP == ch) ? &config->group_digits : &config->line_digits, optarg)) {
+          fprintf(stderr, "Something went wrong while parsing argument for option --%s.\nPlease use -h or --help for valid function call examples\n", (OPTION_GROUP == ch) ? "group" : "line");
+          return false;
+        }
+        break;
       
       case '?':
         fprintf(stderr, "Use --help or -h for available command-line arguments\n");
         return false;
     }
   }
+  if (config->compare && (NULL == config->reference)) {
+    fprintf(stderr, "Option --compare needs a reference file (--reference).\nPlease use -h or --help for valid function call examples\n");
+    return false;
+  }
+  if (config->reference && (config->output_count || config->range || config->server || config->client || config->test)) {
+    fprintf(stderr, "Options --reference and --compare can not be combined with --base, --range, --server, --client or -t.\nPlease use -h or --help for valid function call examples\n");
+    return false;
+  }
+  return true;
+}
+
+/*
+  Compares the digits of 'text' with the reference file at 'path' and reports the first differing place after the point.
+  Fails, if the texts differ or the reference ends before the text.
+*/
+static bool compare_reference(const char * text, size_t size, const char * path) {
+  reference_file_t reference;
+  if (!reference_open(&reference, path))
+    return false;
+
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  reference_match_t match = reference_compare(text, size, reference.data, reference.size);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  reference_close(&reference);
+  double time = end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec);
+
+  uint64_t places = match.digits ? match.digits - 1 : 0; // Without the place in front of the point.
+  if (!match.mismatch && (0 == match.digits)) {
+    fprintf(stderr, "Comparison with %s failed: no digits to compare\n", path);
+    return false;
+  }
+  if (match.mismatch) {
+    if (match.digits)
+      fprintf(stderr, "Comparison with %s failed: first difference at place %" PRIu64 " after the point\n", path, match.digits);
+    else
+      fprintf(stderr, "Comparison with %s failed: the places in front of the point differ\n", path);
+    return false;
+  }
+  if (!match.first_ended) {
+    fprintf(stderr, "Comparison with %s failed: the reference ends after %" PRIu64 " places\n", path, places);
+    return false;
+  }
+  printf("Comparison of %" PRIu64 " places with %s passed in %f seconds\n", places, path, time);
   return true;
 }
 
@@ -121,21 +339,80 @@ int main(int argc, char *argv[]) {
     .show_time = false,
     .test = false,
     .test_numeral_system = 10,
+    .truncate = false,
+    .verify = false,
+    .check_mul = false,
+    .stats = false,
+    .perf_counters = false,
+    .max_memory = 0,
+    .threads = 1,
+    .huge_pages = HUGE_PAGES_TRANSPARENT,
+    .numa_policy = NUMA_DEFAULT,
+    .numa_node = 0,
+    .group_digits = 0,
+    .line_digits = 0,
+    .range = false,
+    .file = NULL,
+    .reference = NULL,
+    .compare = NULL,
+    .server = false,
+    .socket = NULL,
+    .client = NULL,
+    .decimal_digits = -1,
+    .hexadecimal_digits = -1,
+    .output_count = 0,
   };
 
   /* Parcing command-line arguments */ 
   if (!parse_options(&config, argc, argv))
     return EXIT_FAILURE;
 
+  /* Counters are inherited by threads created later, so they are opened before the thread pool */
+  if (config.perf_counters && !stats_perf_open())
+    fprintf(stderr, "--perf-counters: no counter available, only times are reported\n");
+
+  /* All calculations of the program run in one context, that is current for the main thread */
+  wurzel_context_t * context = wurzel_context_create(config.threads);
+  if (NULL == context)
+    return EXIT_FAILURE;
+  context->truncated_splitting = config.truncate;
+  context->checked_multiplication = config.check_mul;
+  context->memory_limit = config.max_memory;
+  context->huge_pages = config.huge_pages;
+  context->numa_policy = config.numa_policy;
+  context->numa_node = config.numa_node;
+  context->group_digits = config.group_digits;
+  context->line_digits = config.line_digits;
+  context_enter(context);
+
   /* In case option for help was set, help-message will be shown and program ends afterwards */ 
   if (config.show_help) {
     printf("\n\nOptions:\n\n");
-    printf("-V <Zahl>\tSpecifies which implementation to use. -V 0 should use the main implementation.  \n\t\tIf this option is not set, the main implementation should also be executed. (Default: 0)\n\n");
+    printf("-V <Zahl>\tSpecifies which implementation to use. -V 0 should use the main implementation.  \n\t\t-V 3 uses a third order iteration without division.\n\t\tIf this option is not set, the main implementation should also be executed. (Default: 0)\n\n");
     printf("-B <Zahl>\tIf set, the runtime of the specified implementation is measured and displayed.\n \t\tThe optional argument of this flag specifies the number of repetitions of the function call. (Default: 1)\n\n");
     printf("-d <Zahl>\tOutput of n decimal digits after the decimal point. Has priority over -h. (Default: 10)\n\n");
     printf("-h <Zahl>\tOutput of n hexadecimal digits after the decimal point. (Default: 10)\n\n");
     printf("-h \t\tA description of all the options of the program and usage examples.\n\n");
     printf("--help\t\tA description of all the options of the program and usage examples.\n\n");
+    printf("--truncate\tTruncated Binary Splitting for -V 0 and -V 1: values longer than the required precision are kept as\n\t\tfloating point numbers. The error is tracked and compensated by guard digits.\n\n");
+    printf("--verify\tChecks the result without reference values: x ^ 2 <= 2 < (x + ulp) ^ 2, where x is the printed value\n\t\tand ulp is the value of its last place. Fails, if the check does not hold.\n\n");
+    printf("--check-mul\tEvery large product is checked modulo two word-sized primes. A failing product is calculated again,\n\t\tif it fails twice, the program is aborted.\n\n");
+    printf("--stats\t\tReport of wall and CPU time per phase, calls and operand digits per arithmetic routine and the\n\t\twork of each multiplication tier. Printed to stderr. Not available, if built with 'make STATS=0'.\n\n");
+    printf("--perf-counters\tLike --stats, additionally cycles, instructions (IPC), cache misses, branch misses and page faults\n\t\tper phase from Linux perf_event_open and the misses per digit. Counters, that are not available, are skipped.\n\n");
+    printf("--max-memory <Größe>\tLimit for the memory of all bignums in bytes, suffixes K, M and G are allowed.\n\t\tThe calculation fails early with an error, if the limit would be exceeded.\n\n");
+    printf("--threads <Zahl>\tNumber of threads for Binary Splitting (-V 0 and -V 1), including the main thread. (Default: 1)\n\n");
+    printf("--range <Start>:<Länge>\tOutput of the places Start .. Start + Länge - 1 after the point (counted from 1) of -d or -h.\n\t\tThey are read from a result file, root of 2 is only calculated, if the file does not contain them.\n\n");
+    printf("--file <Pfad>\tResult file for --range. (Default: sqrt2_dec.w2 or sqrt2_hex.w2)\n\n");
+    printf("--reference <Pfad>\tCompares the complete output with a reference file of the same numeral system (e.g. a\n\t\tdownloaded digit file \"1.4142...\", spaces and line breaks are skipped) and reports the first differing place.\n\n");
+    printf("--compare <Pfad>\tCompares a saved output file with the file of --reference instead of calculating.\n\n");
+    printf("--server\tServer mode: reads requests \"<Basis> <Zahl> [<Version>]\" line by line from stdin and prints one line with\n\t\tthe root of 2 for each of them. Requests, that arrive during a calculation, are answered together.\n\n");
+    printf("--socket <Pfad>\tServer mode with requests from a Unix socket instead of stdin. Ends with SIGINT or SIGTERM.\n\n");
+    printf("--client <Pfad>\tSends the requests from stdin to the server at the Unix socket and prints its answers.\n\n");
+    printf("--base <Basis>:<Zahl>\tAdditional output of n places in numeral system 2 .. 36, may be given several times.\n\t\tIf set, -d and -h are both printed as well. Root of 2 is calculated once in base 16 and converted, every\n\t\tnumeral system is printed in one line in the order -d, -h, --base.\n\n");
+    printf("--huge-pages <Modus>\tHuge pages for bignums of at least 2 MiB: off, transparent or explicit (reserved pages,\n\t\ttransparent huge pages if none are left). (Default: transparent)\n\n");
+    printf("--numa <Modus>\tPlacement of bignums of at least 2 MiB on NUMA nodes: interleave over all nodes or the number of\n\t\tone node. By default, pages are placed on the node of the thread, that writes them first.\n\n");
+    printf("--group <Zahl>\tThe places after the point are printed in groups of n places, separated by a space.\n\n");
+    printf("--line <Zahl>\tThe places after the point are printed with n places per line.\n\n");
     printf("-t <Zahl>\tRun automatic tests. The optional argument of this flag specifies the numeral system the test should be executed for.\n\t\tMust be 10 for DECIMAL or 16 for HEXADECIMAl.\n\t\tCan be paired with other options in order to test correctness or measure and dispaly runtime of certain implementation. See usage examples.\n\n");
 
     printf("Usage examples:\n\n");
@@ -149,13 +426,98 @@ int main(int argc, char *argv[]) {
     printf("Example Input:  -t 10 -V 1 -B 10\nExample output: Too large to dispaly here\nExplanation: \tExecute time measurments for VERSION_1 in DECIMAL format on 10 iteration minimum.\n\n");
   }
 
-  /* In case option for testing was set, tests are going to be executed and program ends afterwards */ 
-  if (config.test) { 
-    config.numeral_system = (config.test_numeral_system == 10) ? DECIMAL : HEXADECIMAL;
-    if (!test(config)) {
+  /* In case option for server or client mode was set, the program ends after the mode */
+  if (config.server || config.client) {
+    bool success = config.client ? client_run(config.client) : server_run(context, config.socket);
+    if (config.stats)
+      wurzel_report(context, stderr);
+    wurzel_context_destroy(context);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  /* In case option for several numeral systems was set, all of them are printed and program ends afterwards */
+  if (config.output_count > 0) {
+    /* -d and -h are printed first */
+    int extra = (config.decimal_digits >= 0) + (config.hexadecimal_digits >= 0);
+    memmove(&config.output_bases[extra], config.output_bases, config.output_count * sizeof(config.output_bases[0]));
+    memmove(&config.output_digits[extra], config.output_digits, config.output_count * sizeof(config.output_digits[0]));
+    config.output_count += extra;
+    int next = 0;
+    if (config.decimal_digits >= 0) {
+      config.output_bases[next] = 10;
+      config.output_digits[next++] = config.decimal_digits;
+    }
+    if (config.hexadecimal_digits >= 0) {
+      config.output_bases[next] = 16;
+      config.output_digits[next++] = config.hexadecimal_digits;
+    }
+
+    char * results[MAX_OUTPUTS];
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool success = wurzel_sqrt2_bases(context, config.output_count, config.output_bases, config.output_digits, config.version, results);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (!success) {
+      fprintf(stderr, "Calculation in %d numeral systems failed!\n", config.output_count);
+      wurzel_context_destroy(context);
+      return EXIT_FAILURE;
+    }
+
+    STATS_PHASE_BEGIN(PHASE_OUTPUT);
+    for (int i = 0; i < config.output_count; ++i) {
+      printf("%s\n", results[i]);
+      free(results[i]);
+    }
+    fflush(stdout);
+    STATS_PHASE_END(PHASE_OUTPUT);
+
+    if (config.show_time)
+      printf("Calculated %d numeral systems in %f seconds\n", config.output_count, end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec));
+    if (config.stats)
+      wurzel_report(context, stderr);
+    wurzel_context_destroy(context);
+    return EXIT_SUCCESS;
+  }
+
+  /* In case option for comparing a saved output was set, both files are compared and program ends afterwards */
+  if (config.compare) {
+    reference_file_t output;
+    bool passed = reference_open(&output, config.compare);
+    passed = passed && compare_reference(output.data, output.size, config.reference);
+    reference_close(&output);
+    wurzel_context_destroy(context);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  /* In case option for a range was set, only the range is printed and program ends afterwards */
+  if (config.range) {
+    char * path = config.file ? config.file : ((config.numeral_system == DECIMAL) ? "sqrt2_dec.w2" : "sqrt2_hex.w2");
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char * places = wurzel_range(context, path, config.numeral_system, config.version, config.range_start, config.range_length);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (NULL == places) {
+      fprintf(stderr, "Query of range %" PRIu64 ":%" PRIu64 " failed!\n", config.range_start, config.range_length);
+      wurzel_context_destroy(context);
       return EXIT_FAILURE;
     }
+
+    printf("%s\n", places);
+    if (config.show_time)
+      printf("Range of %" PRIu64 " places read in %f seconds\n", config.range_length, end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec));
+    free(places);
+    wurzel_context_destroy(context);
     return EXIT_SUCCESS;
+  }
+
+  /* In case option for testing was set, tests are going to be executed and program ends afterwards */ 
+  if (config.test) { 
+    config.numeral_system = (config.test_numeral_system == 10) ? DECIMAL : HEXADECIMAL;
+    bool passed = test(config);
+    wurzel_context_destroy(context);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
   } 
   else {
     struct bignum sqrt2_value;
@@ -166,28 +528,28 @@ int main(int argc, char *argv[]) {
     struct timespec end;
     int i;
     char * version; // for the output of the results
-    struct bignum (* current_sqrt) (size_t, numeral_system_t) = sqrt2;
 
     switch (config.version) {
       case VERSION_0:
         version = "Hauptimplementierung";
-        current_sqrt = sqrt2;
         break;
       
       case VERSION_1:
         version = "VERSION_1";
-        current_sqrt = sqrt2_V1;
         break;
 
       case VERSION_2:
         version = "VERSION_2";
-        current_sqrt = sqrt2_V2;
         break; 
+
+      case VERSION_3:
+        version = "VERSION_3";
+        break;
     }
     struct bignum sqrt2_values[config.iteration];
     clock_gettime(CLOCK_MONOTONIC, &start);
     for (i = 0; i < config.iteration; ++i)
-     sqrt2_values[i] = current_sqrt(config.digits, config.numeral_system);
+     sqrt2_values[i] = wurzel_sqrt2(context, config.digits, config.numeral_system, config.version);
     clock_gettime(CLOCK_MONOTONIC, &end);
 
     sqrt2_value = sqrt2_values[0];
@@ -195,26 +557,69 @@ int main(int argc, char *argv[]) {
       free_bignum(&sqrt2_values[i]);
     }
 
-    double time = ((end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec)) / config.iteration);
+    if (NULL == sqrt2_value.mantissa) {
+      fprintf(stderr, "Calculation of %zu digits failed!\n", config.digits);
+      if (context->memory_exhausted)
+        fprintf(stderr, "Peak memory of bignums: %zu bytes\n", context->memory_peak);
+      wurzel_context_destroy(context);
+      return EXIT_FAILURE;
+    }
 
-    char * result = build_string(sqrt2_value, config.digits);
+    double time = ((end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec)) / config.iteration);
 
-    /* Adjusting output of the result */
-    if (config.digits == 0) {
-      result[1] = 0;
-    } else {
-      result[config.digits + 2] = 0;
+    char * result = wurzel_format(context, sqrt2_value, config.digits);
+    if (NULL == result) {
+      fprintf(stderr, "Formatting of %zu digits failed!\n", config.digits);
+      if (context->memory_exhausted)
+        fprintf(stderr, "Peak memory of bignums: %zu bytes\n", context->memory_peak);
+      free_bignum(&sqrt2_value);
+      wurzel_context_destroy(context);
+      return EXIT_FAILURE;
     }
 
+    STATS_PHASE_BEGIN(PHASE_OUTPUT);
     printf("%s\n", result);
+    fflush(stdout);
+    STATS_PHASE_END(PHASE_OUTPUT);
+
+    /* In case a reference file was given, the printed digits are compared with it */
+    bool matched = (NULL == config.reference) || compare_reference(result, strlen(result), config.reference);
     free(result);
+    if (!matched) {
+      free_bignum(&sqrt2_value);
+      wurzel_context_destroy(context);
+      return EXIT_FAILURE;
+    }
+
+    /* In case option for verification was set, the printed digits are checked */
+    bool verified = true;
+    double verify_time = 0;
+    if (config.verify) {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      verified = wurzel_verify(context, sqrt2_value, config.digits);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      verify_time = end.tv_sec - start.tv_sec + 1e-9 * (end.tv_nsec - start.tv_nsec);
+    }
     free_bignum(&sqrt2_value);
 
     /* In case option for time measurment was set, above measured time will be shown */ 
     char * numeral_system_string = (config.numeral_system == DECIMAL) ? "decimal" : "hexadecimal";
     if (config.show_time == true) {
-      printf("%s calculated %d %s digits in %f seconds\n", version, config.digits, numeral_system_string, time);
+      printf("%s calculated %zu %s digits in %f seconds\n", version, config.digits, numeral_system_string, time);
     }
+
+    if (config.verify) {
+      if (!verified) {
+        fprintf(stderr, "Verification of %zu %s digits failed!\n", config.digits, numeral_system_string);
+        wurzel_context_destroy(context);
+        return EXIT_FAILURE;
+      }
+      printf("Verification of %zu %s digits passed in %f seconds\n", config.digits, numeral_system_string, verify_time);
+    }
+
+    if (config.stats)
+      wurzel_report(context, stderr);
+    wurzel_context_destroy(context);
     return EXIT_SUCCESS;
   }
 }
@@ -5,6 +5,8 @@
 #include <emmintrin.h>
 
 #include "headers/mul.h"
+#include "headers/stats.h"
+#include "headers/wurzel.h"
 
 /*  
   Simple multiplication, works in O(a.mantissa_size * b.mantissa_size) time.
@@ -23,27 +25,29 @@ struct bignum mul_bignum_V0(struct bignum a, struct bignum b) {
   /* Precautions */
   normalize(&a);
   normalize(&b);
+  STATS_COUNT(OPERATION_MUL_V0, a.mantissa_size + b.mantissa_size, (uint64_t)a.mantissa_size * b.mantissa_size);
   
   result.mantissa_size = a.mantissa_size + b.mantissa_size;
   result.exponent = a.exponent + b.exponent; // By Multiplication lenth of decimal parts are summed up
   result.negative = a.negative ^ b.negative;
   result.base = a.base;
   
-  result.deallocate = result.mantissa = calloc(result.mantissa_size, sizeof(result.mantissa[0]));
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size, sizeof(result.mantissa[0]));
   if (NULL == result.mantissa) {
-    fprintf(stderr, "Multiplication: Memory allocation error!\n" "%d bytes could not be allocated\n", result.mantissa_size);
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "Multiplication: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", result.mantissa_size);
     return result;
   }
  
-  uint32_t i, j;
-  uint32_t carry = 0;
+  uint64_t i, j;
+  uint64_t carry = 0; // Sum of up to min{|a|, |b|} digit products, 32 bits overflow for long factors.
   for (i = 0; i < result.mantissa_size; ++i) {
-    uint32_t l = 0;
+    uint64_t l = 0;
     if (b.mantissa_size + l < i + 1) { // l = max{0, i + 1 - |b|}
       l = i + 1 - b.mantissa_size;
     }
     
-    uint32_t r = i;
+    uint64_t r = i;
     if (r > a.mantissa_size - 1) { // r =  min{|a| - 1, i}
       r = a.mantissa_size - 1;
     }
@@ -75,35 +79,37 @@ struct bignum mul_bignum_V1(struct bignum a, struct bignum b) {
   /* Precautions */
   normalize(&a);
   normalize(&b);
+  STATS_COUNT(OPERATION_MUL_V1, a.mantissa_size + b.mantissa_size, (uint64_t)a.mantissa_size * b.mantissa_size);
   
   result.mantissa_size = a.mantissa_size + b.mantissa_size;
   result.exponent = a.exponent + b.exponent; // By Multiplication lenth of decimal parts are summed up
   result.negative = a.negative ^ b.negative;
   result.base = a.base;
   
-  result.deallocate = result.mantissa = calloc(result.mantissa_size, sizeof(result.mantissa[0]));
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size, sizeof(result.mantissa[0]));
   if (NULL == result.mantissa) {
-    fprintf(stderr, "Multiplication: Memory allocation error!\n" "%d bytes could not be allocated\n", result.mantissa_size);
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "Multiplication: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", result.mantissa_size);
     return result;
   }
 
   #define VEC_SIZE (8)
 
-  uint32_t i, j;
-  uint32_t carry = 0;
+  uint64_t i, j;
+  uint64_t carry = 0;
   for (i = 0; i < result.mantissa_size; ++i) {
-  	uint32_t l = 0;
+  	uint64_t l = 0;
   	if (b.mantissa_size + l < i + 1) {
   		l = i + 1 - b.mantissa_size;
     }
   	
-  	uint32_t r = i + 1;
+  	uint64_t r = i + 1;
   	if (r > a.mantissa_size) {
   		r = a.mantissa_size;
     }
   	
   	for (j = l; j + VEC_SIZE < r; j += VEC_SIZE) {
-      int32_t i_minus_j = i - j;
+      int64_t i_minus_j = i - j;
       __m128i vector_a = _mm_set_epi16(a.mantissa[j], a.mantissa[j + 1], a.mantissa[j + 2], a.mantissa[j + 3], a.mantissa[j + 4], a.mantissa[j + 5], a.mantissa[j + 6], a.mantissa[j + 7]);
       __m128i vector_b = _mm_set_epi16(b.mantissa[i_minus_j], b.mantissa[i_minus_j - 1], b.mantissa[i_minus_j - 2], b.mantissa[i_minus_j - 3], b.mantissa[i_minus_j - 4], b.mantissa[i_minus_j - 5], b.mantissa[i_minus_j - 6], b.mantissa[i_minus_j - 7]);
 	    __m128i a_mul_b = _mm_mullo_epi16(vector_a, vector_b);
@@ -122,7 +128,91 @@ struct bignum mul_bignum_V1(struct bignum a, struct bignum b) {
   return result;
 }
 
-extern bool vectorised;
+/* Only products, whose factors have at least CHECK_MIN_DIGITS digits together (sum of both sizes), are checked */
+#define CHECK_MIN_DIGITS (1024)
+
+/* Primes less than 2 ^ 32 for the checksums, so that products of residues fit into uint64_t */
+static const uint64_t check_primes[] = { 4294967291u, 4294967279u };
+
+/* 
+  Residue of the integer, that consists of the digits of x.mantissa, modulo p (Horner's method).
+  Digits are collected in chunks less than 2 ^ 32, so that only one modulo operation per chunk is required.
+*/
+static uint64_t residue(struct bignum x, uint64_t p) {
+  uint64_t result = 0;
+  size_t i = x.mantissa_size;
+  while (i > 0) {
+    uint64_t chunk = 0, chunk_base = 1;
+    for ( ; (i > 0) && (chunk_base * x.base <= UINT32_MAX); --i) {
+      chunk = chunk * x.base + x.mantissa[i - 1];
+      chunk_base *= x.base;
+    }
+    result = (result * chunk_base + chunk) % p;
+  }
+  return result;
+}
+
+/* base ^ exponent modulo p */
+static uint64_t power_mod(uint64_t base, uint64_t exponent, uint64_t p) {
+  uint64_t result = 1;
+  base %= p;
+  for ( ; exponent; exponent >>= 1) {
+    if (exponent & 1)
+      result = result * base % p;
+    base = base * base % p;
+  }
+  return result;
+}
+
+/*
+  Checks c = a * b modulo a few word-sized primes in O(n) time.
+  Value of x is M(x) * base ^ (x.exponent - x.mantissa_size), where M(x) is the integer with the digits of x.mantissa.
+  Trailing zeroes of the product are removed by normalize(), so the check has to compensate the difference d of 
+  the shifts: M(a) * M(b) = M(c) * base ^ d.
+*/
+static bool product_is_consistent(struct bignum a, struct bignum b, struct bignum c) {
+  normalize(&a);
+  normalize(&b);
+  normalize(&c);
+
+  int64_t d = (c.exponent - (int64_t)c.mantissa_size) - ((a.exponent - (int64_t)a.mantissa_size) + (b.exponent - (int64_t)b.mantissa_size));
+  for (size_t i = 0; i < sizeof(check_primes) / sizeof(check_primes[0]); ++i) {
+    uint64_t p = check_primes[i];
+    uint64_t left = residue(a, p) * residue(b, p) % p;
+    uint64_t right = residue(c, p);
+
+    if (d >= 0) 
+      right = right * power_mod(c.base, d, p) % p;
+    else 
+      left = left * power_mod(c.base, -d, p) % p;
+
+    if (left != right)
+      return false;
+  }
+  return (a.negative ^ b.negative) == c.negative || (1 == c.mantissa_size && 0 == c.mantissa[0]);
+}
+
+/* 
+  Runs a multiplication and, if checked_multiplication is set in the current context, checks its result with modular checksums. 
+  A failing product is calculated once more, in case it fails again the program is aborted.
+*/
+static struct bignum checked_product(struct bignum (* multiplication) (struct bignum, struct bignum), struct bignum a, struct bignum b) {
+  struct bignum result = multiplication(a, b);
+  if (!context_current()->checked_multiplication || (NULL == result.mantissa) || (a.mantissa_size + b.mantissa_size < CHECK_MIN_DIGITS))
+    return result;
+
+  for (int attempt = 0; !product_is_consistent(a, b, result); ++attempt) {
+    free_bignum(&result);
+    if (attempt > 0) {
+      fprintf(stderr, "Multiplication: checksum mismatch for %" PRIu64 " x %" PRIu64 " digits persists, aborting!\n", a.mantissa_size, b.mantissa_size);
+      abort();
+    }
+
+    fprintf(stderr, "Multiplication: checksum mismatch for %" PRIu64 " x %" PRIu64 " digits, calculating the product again\n", a.mantissa_size, b.mantissa_size);
+    result = multiplication(a, b);
+  }
+  return result;
+}
 
 /*
   Karazuba-Multiplikation: works in O((max{a.mantissa_size, b.mantissa_size}) ^ 1.59) time.
@@ -133,8 +223,8 @@ extern bool vectorised;
   = ah * bh + ((ah + al) * (bh + bl) - ah * bh - al * bl) * base ^ (-half_size) + al * bl * base ^ (-2 * half_size) =
   = ahbh + (ahal * bhbl - ahbh - albl) * base ^ (-half_size) + albl * base ^ (-2 * half_size).
 */
-struct bignum mul_bignum_karazuba(struct bignum a, struct bignum b) {
-  bool vectorized_mul = vectorised;
+static struct bignum karazuba(struct bignum a, struct bignum b) {
+  bool vectorized_mul = context_current()->vectorised;
   struct bignum result;
   memset(&result, 0, sizeof (result));
 
@@ -155,6 +245,7 @@ struct bignum mul_bignum_karazuba(struct bignum a, struct bignum b) {
     a = b;
     b = swap;
   }
+  STATS_COUNT(OPERATION_MUL_KARAZUBA, a.mantissa_size + b.mantissa_size, (b.mantissa_size > 32) ? 1 : 0);
 
   /* If significant positions of b less than 32 -> simple multiplication works faster than Karazuba */
   if (b.mantissa_size <= 32) {
@@ -251,3 +342,80 @@ struct bignum mul_bignum_karazuba(struct bignum a, struct bignum b) {
 
   return result;
 }
+
+/* Karazuba-Multiplikation, see above. Products are checked with modular checksums in case of --check-mul */
+struct bignum mul_bignum_karazuba(struct bignum a, struct bignum b) {
+  return checked_product(karazuba, a, b);
+}
+
+/*
+  Karazuba-Squaring: works like mul_bignum_karazuba, but needs only three squarings of half length per step:
+  a' ^ 2 = (ah + al * base ^ (-half_size)) ^ 2 = 
+  = ah ^ 2 + ((ah + al) ^ 2 - ah ^ 2 - al ^ 2) * base ^ (-half_size) + al ^ 2 * base ^ (-2 * half_size).
+*/
+static struct bignum karazuba_sqr(struct bignum a, struct bignum unused) {
+  (void)unused;
+  struct bignum result;
+  memset(&result, 0, sizeof (result));
+
+  /* Checking that a is valid bignum */
+  if ((NULL == a.mantissa) || (0 == a.mantissa_size))
+    return result;
+
+  /* Precautions */
+  normalize(&a);
+  STATS_COUNT(OPERATION_SQR_KARAZUBA, a.mantissa_size << 1, (a.mantissa_size > 32) ? 1 : 0);
+
+  if (a.mantissa_size <= 32) {
+    if (context_current()->vectorised) {
+      return mul_bignum_V1(a, a); // vectorized multiplikation
+    }
+    return mul_bignum_V0(a, a); // sequential multiplication 
+  }
+
+  /* a = ah + al * base ^ (-half_mantissa_size), see mul_bignum_karazuba */
+  size_t half_mantissa_size = (a.mantissa_size + 1) >> 1;
+  struct bignum al, ah;
+  memset(&al, 0, sizeof(al));
+  memset(&ah, 0, sizeof(ah));
+
+  ah.mantissa = &a.mantissa[a.mantissa_size - half_mantissa_size];
+  ah.mantissa_size = half_mantissa_size;
+  ah.base = a.base;
+  
+  al.mantissa = a.mantissa;
+  al.mantissa_size = a.mantissa_size - half_mantissa_size;
+  al.base = a.base;
+
+  struct bignum ah_sqr = sqr_bignum_karazuba(ah);
+  struct bignum al_sqr = sqr_bignum_karazuba(al);
+  struct bignum ah_add_al = add_bignum(ah, al);
+  struct bignum ahal_sqr = sqr_bignum_karazuba(ah_add_al);
+  struct bignum ahal_sqr_sub_ahsqr = sub_bignum(ahal_sqr, ah_sqr);
+  struct bignum double_ah_mul_al = sub_bignum(ahal_sqr_sub_ahsqr, al_sqr);
+
+  double_ah_mul_al.exponent -= half_mantissa_size; // multiplication by (base ^ (-half_size))
+  struct bignum ahsqr_add_double_ah_mul_al = add_bignum(ah_sqr, double_ah_mul_al);
+  al_sqr.exponent -= half_mantissa_size << 1; // multiplication by (base ^ (-2 * half_size))
+  result = add_bignum(ahsqr_add_double_ah_mul_al, al_sqr);
+
+  /* Memory deallocation of temporary results */
+  free_bignum(&ahsqr_add_double_ah_mul_al);
+  free_bignum(&double_ah_mul_al);
+  free_bignum(&ahal_sqr_sub_ahsqr);
+  free_bignum(&ahal_sqr);
+  free_bignum(&ah_add_al);
+  free_bignum(&al_sqr);
+  free_bignum(&ah_sqr);
+
+  /* Returning the exponent to the result: squaring doubles the length of decimal part */
+  result.exponent += a.exponent << 1;
+  result.negative = false;
+
+  return result;
+}
+
+/* Karazuba-Squaring, see above. Squares are checked with modular checksums in case of --check-mul */
+struct bignum sqr_bignum_karazuba(struct bignum a) {
+  return checked_product(karazuba_sqr, a, a);
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/pool.h"
+#include "headers/wurzel.h"
+
+/* Main loop of a worker: takes queued tasks until the pool shuts down */
+static void * worker(void * argument) {
+  thread_pool_t * pool = argument;
+  context_enter(pool->context);
+
+  pthread_mutex_lock(&pool->mutex);
+  while (true) {
+    while (!pool->shutdown && (NULL == pool->head))
+      pthread_cond_wait(&pool->task_available, &pool->mutex);
+    if (pool->shutdown)
+      break;
+
+    pool_task_t * task = pool->head;
+    pool->head = task->next;
+    if (NULL == pool->head)
+      pool->tail = NULL;
+    task->state = TASK_RUNNING;
+    pthread_mutex_unlock(&pool->mutex);
+
+    task->function(task->argument);
+
+    pthread_mutex_lock(&pool->mutex);
+    task->state = TASK_DONE;
+    pthread_cond_broadcast(&pool->task_done);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+thread_pool_t * pool_create(struct wurzel_context_t * context, int worker_count) {
+  thread_pool_t * pool = calloc(1, sizeof(*pool));
+  if (NULL == pool) {
+    fprintf(stderr, "pool_create: Memory allocation error!\n");
+    return NULL;
+  }
+
+  pool->workers = calloc(worker_count, sizeof(pool->workers[0]));
+  if (NULL == pool->workers) {
+    fprintf(stderr, "pool_create: Memory allocation error!\n");
+    free(pool);
+    return NULL;
+  }
+
+  pool->context = context;
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->task_available, NULL);
+  pthread_cond_init(&pool->task_done, NULL);
+
+  for ( ; pool->worker_count < worker_count; ++pool->worker_count) {
+    if (pthread_create(&pool->workers[pool->worker_count], NULL, worker, pool)) {
+      fprintf(stderr, "pool_create: Could not start worker thread %d!\n", pool->worker_count + 1);
+      pool_destroy(pool);
+      return NULL;
+    }
+  }
+  return pool;
+}
+
+void pool_destroy(thread_pool_t * pool) {
+  if (NULL == pool)
+    return;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->task_available);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (int i = 0; i < pool->worker_count; ++i)
+    pthread_join(pool->workers[i], NULL);
+
+  pthread_cond_destroy(&pool->task_done);
+  pthread_cond_destroy(&pool->task_available);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->workers);
+  free(pool);
+}
+
+void pool_submit(thread_pool_t * pool, pool_task_t * task) {
+  task->state = TASK_QUEUED;
+  task->next = NULL;
+
+  pthread_mutex_lock(&pool->mutex);
+  if (pool->tail)
+    pool->tail->next = task;
+  else
+    pool->head = task;
+  pool->tail = task;
+  pthread_cond_signal(&pool->task_available);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+void pool_wait(thread_pool_t * pool, pool_task_t * task) {
+  pthread_mutex_lock(&pool->mutex);
+  if (TASK_QUEUED == task->state) {
+    /* Nobody took the task yet -> removing it from the queue and running it in this thread */
+    pool_task_t ** link = &pool->head;
+    pool_task_t * previous = NULL;
+    while (*link != task) {
+      previous = *link;
+      link = &(*link)->next;
+    }
+    *link = task->next;
+    if (pool->tail == task)
+      pool->tail = previous;
+    task->state = TASK_RUNNING;
+    pthread_mutex_unlock(&pool->mutex);
+
+    task->function(task->argument);
+
+    pthread_mutex_lock(&pool->mutex);
+    task->state = TASK_DONE;
+  }
+
+  while (TASK_DONE != task->state)
+    pthread_cond_wait(&pool->task_done, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,301 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/radix.h"
+#include "headers/add_sub.h"
+#include "headers/mul.h"
+#include "headers/stats.h"
+#include "headers/wurzel.h"
+
+/* Integers with at least RADIX_PARALLEL_DIGITS digits convert their two halves on different threads */
+#define RADIX_PARALLEL_DIGITS (4096)
+
+/* Powers from ^ (2 ^ level) in numeral system 'to', calculated before and shared by the whole conversion */
+typedef struct radix_powers_t {
+  struct bignum powers[64];
+  size_t count;
+  uint32_t from, to;
+} radix_powers_t;
+
+/* k, if base = 2 ^ k, otherwise 0 */
+static uint32_t exact_log2(uint32_t base) {
+  uint32_t k = 0;
+  while ((1u << k) < base)
+    ++k;
+  return ((1u << k) == base) ? k : 0;
+}
+
+/* floor(x * base ^ shift) as integer with all its digits stored (no stripped zeros), least significant digit first */
+static struct bignum floor_integer(struct bignum x, int64_t shift) {
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  result.base = x.base;
+
+  int64_t length = (int64_t)x.exponent + shift;
+  result.mantissa_size = (length > 0) ? length : 1;
+  result.exponent = result.mantissa_size;
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size, sizeof(result.mantissa[0]));
+  if (NULL == result.mantissa) {
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "radix_convert: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", result.mantissa_size);
+    return result;
+  }
+
+  /* Digit i of x has the weight i - mantissa_size + exponent + shift in the result */
+  for (int64_t weight = 0; weight < length; ++weight) {
+    int64_t index = weight + x.mantissa_size - x.exponent - shift;
+    if ((index >= 0) && (index < (int64_t)x.mantissa_size))
+      result.mantissa[weight] = x.mantissa[index];
+  }
+  return result;
+}
+
+/* value ^ exponent in numeral system 'base' by repeated squaring */
+static struct bignum integer_power(uint32_t value, size_t exponent, uint32_t base) {
+  struct bignum result = bignum_uint64(1, base);
+  struct bignum square = bignum_uint64(value, base);
+  while (exponent) {
+    if (exponent & 1) {
+      struct bignum product = mul_bignum_karazuba(result, square);
+      free_bignum(&result);
+      result = product;
+    }
+    exponent >>= 1;
+    if (exponent) {
+      struct bignum next = sqr_bignum_karazuba(square);
+      free_bignum(&square);
+      square = next;
+    }
+  }
+  free_bignum(&square);
+  return result;
+}
+
+/* Integer with 'length' digits (least significant first) in numeral system 'from' converted by Horner's method */
+static struct bignum convert_basecase(const uint8_t * digits, size_t length, uint32_t from, uint32_t to) {
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+
+  uint8_t buffer[RADIX_BASECASE_DIGITS * 8 + 1]; // from <= 2 ^ 8 and to >= 2
+  uint32_t used = 1;
+  buffer[0] = 0;
+  for (size_t i = length; i-- > 0; ) {
+    uint32_t carry = digits[i];
+    for (uint32_t j = 0; j < used; ++j) {
+      uint32_t value = buffer[j] * from + carry;
+      buffer[j] = value % to;
+      carry = value / to;
+    }
+    for ( ; carry; carry /= to)
+      buffer[used++] = carry % to;
+  }
+
+  result.mantissa_size = used;
+  result.exponent = used;
+  result.base = to;
+  result.deallocate = result.mantissa = bignum_calloc(used, sizeof(result.mantissa[0]));
+  if (NULL == result.mantissa) {
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "radix_convert: Memory allocation error!\n" "%u bytes could not be allocated\n", used);
+    return result;
+  }
+  memcpy(result.mantissa, buffer, used);
+  normalize(&result);
+  return result;
+}
+
+/* Level of the split of an integer with 'length' digits: k = 2 ^ level < length <= 2 ^ (level + 1) */
+static size_t split_level(size_t length) {
+  size_t level = 0;
+  while (((size_t)2 << level) < length)
+    ++level;
+  return level;
+}
+
+/* Calculates all powers needed for the conversion of 'length' digits, so that threads can share the table */
+static void prepare_powers(radix_powers_t * powers, size_t length) {
+  if (length <= RADIX_BASECASE_DIGITS)
+    return;
+  size_t level = split_level(length);
+  while (powers->count <= level) {
+    powers->powers[powers->count] = (0 == powers->count) ? bignum_uint64(powers->from, powers->to) :
+      sqr_bignum_karazuba(powers->powers[powers->count - 1]);
+    ++powers->count;
+  }
+}
+
+static struct bignum convert(const uint8_t * digits, size_t length, radix_powers_t * powers);
+
+/* Task of the thread pool for the lower half in convert */
+typedef struct convert_task_t {
+  pool_task_t task;
+  const uint8_t * digits;
+  size_t length;
+  radix_powers_t * powers;
+  struct bignum result;
+} convert_task_t;
+
+static void convert_run(void * argument) {
+  convert_task_t * task = argument;
+  task->result = convert(task->digits, task->length, task->powers);
+}
+
+/*
+  Divide and conquer conversion of an integer with 'length' digits: with k = 2 ^ level < length the value is split into
+  high * from ^ k + low, both parts are converted recursively and combined with the power from the table.
+  If the current context has a thread pool, the lower half of large integers is converted by the pool.
+*/
+static struct bignum convert(const uint8_t * digits, size_t length, radix_powers_t * powers) {
+  if (length <= RADIX_BASECASE_DIGITS)
+    return convert_basecase(digits, length, powers->from, powers->to);
+
+  size_t level = split_level(length);
+  size_t k = (size_t)1 << level;
+  thread_pool_t * pool = context_current()->pool;
+  struct bignum high, low;
+
+  if (pool && (length >= RADIX_PARALLEL_DIGITS)) {
+    convert_task_t low_task = { .digits = digits, .length = k, .powers = powers };
+    low_task.task.function = convert_run;
+    low_task.task.argument = &low_task;
+    pool_submit(pool, &low_task.task);
+    high = convert(digits + k, length - k, powers);
+    pool_wait(pool, &low_task.task);
+    low = low_task.result;
+  } 
+  else {
+    high = convert(digits + k, length - k, powers);
+    low = convert(digits, k, powers);
+  }
+  struct bignum product = mul_bignum_karazuba(high, powers->powers[level]);
+  struct bignum result = add_bignum(product, low);
+
+  free_bignum(&product);
+  free_bignum(&low);
+  free_bignum(&high);
+  return result;
+}
+
+static void free_powers(radix_powers_t * powers) {
+  for (size_t i = 0; i < powers->count; ++i)
+    free_bignum(&powers->powers[i]);
+  powers->count = 0;
+}
+
+/* Converts the integer x into numeral system 'base' */
+struct bignum radix_convert_integer(struct bignum x, uint32_t base) {
+  radix_powers_t powers = { .count = 0, .from = x.base, .to = base };
+  struct bignum digits = floor_integer(x, 0);
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  if (digits.mantissa) {
+    prepare_powers(&powers, digits.mantissa_size);
+    result = convert(digits.mantissa, digits.mantissa_size, &powers);
+  }
+  free_bignum(&digits);
+  free_powers(&powers);
+  return result;
+}
+
+/* Both numeral systems are powers of 2: the bits of the places are regrouped */
+static struct bignum convert_bits(struct bignum x, size_t places, uint32_t base, size_t digits, bool * certain) {
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  uint32_t from_bits = exact_log2(x.base), to_bits = exact_log2(base);
+
+  /* Places of x, that contain the bits of the result; drop bits are below the last place of the result */
+  size_t source_places = (to_bits * digits + from_bits - 1) / from_bits;
+  if (source_places > places) {
+    *certain = false;
+    return result;
+  }
+  size_t drop = from_bits * source_places - to_bits * digits;
+
+  struct bignum source = floor_integer(x, source_places);
+  if (NULL == source.mantissa)
+    return result;
+
+  size_t bits = (size_t)from_bits * source.mantissa_size - drop;
+  result.mantissa_size = (bits + to_bits - 1) / to_bits;
+  result.exponent = (int64_t)result.mantissa_size - (int64_t)digits;
+  result.base = base;
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size, sizeof(result.mantissa[0]));
+  if (NULL == result.mantissa) {
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "radix_convert: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", result.mantissa_size);
+    free_bignum(&source);
+    return result;
+  }
+
+  for (size_t i = 0; i < result.mantissa_size; ++i) {
+    uint8_t digit = 0;
+    for (uint32_t t = 0; t < to_bits; ++t) {
+      size_t bit = drop + i * to_bits + t;
+      if (bit / from_bits < source.mantissa_size)
+        digit |= ((source.mantissa[bit / from_bits] >> (bit % from_bits)) & 1) << t;
+    }
+    result.mantissa[i] = digit;
+  }
+  free_bignum(&source);
+  normalize(&result);
+  return result;
+}
+
+/*
+  Converts x, whose first 'places' places are correct, into numeral system 'base' with 'digits' places:
+  the result is floor(x * base ^ digits) / base ^ digits.
+  With X = floor(x * from ^ places) the true value lies in [X, X + 1) / from ^ places, so its places in 'base' are
+  floor(E / from ^ places) for every E in [X * base ^ digits, (X + 1) * base ^ digits). They are certain, if both ends
+  give the same quotient, i.e. if (X * base ^ digits mod from ^ places) + base ^ digits <= from ^ places. Otherwise
+  certain is set to false and x has to be calculated with more places.
+*/
+struct bignum radix_convert(struct bignum x, size_t places, uint32_t base, size_t digits, bool * certain) {
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  *certain = true;
+
+  if ((NULL == x.mantissa) || (base < 2) || (base > RADIX_MAX_BASE) || (0 == places))
+    return result;
+
+  STATS_PHASE_BEGIN(PHASE_RADIX);
+  if (exact_log2(x.base) && exact_log2(base)) {
+    result = convert_bits(x, places, base, digits, certain);
+    STATS_PHASE_END(PHASE_RADIX);
+    return result;
+  }
+
+  struct bignum integer = floor_integer(x, places);
+  struct bignum power = integer_power(base, digits, x.base);
+  struct bignum product = mul_bignum_karazuba(integer, power);
+  struct bignum product_digits = floor_integer(product, 0);
+  free_bignum(&product);
+  free_bignum(&integer);
+
+  if (product_digits.mantissa && power.mantissa && (product_digits.mantissa_size > places)) {
+    /* Remainder modulo from ^ places plus base ^ digits has to stay below from ^ places + 1 */
+    struct bignum remainder = {
+      .mantissa = product_digits.mantissa,
+      .mantissa_size = places,
+      .exponent = places,
+      .base = x.base,
+    };
+    normalize(&remainder);
+    struct bignum upper = add_bignum(remainder, power);
+    *certain = (NULL != upper.mantissa) && (upper.exponent <= (int64_t)places);
+    free_bignum(&upper);
+
+    if (*certain) {
+      radix_powers_t powers = { .count = 0, .from = x.base, .to = base };
+      prepare_powers(&powers, product_digits.mantissa_size - places);
+      result = convert(product_digits.mantissa + places, product_digits.mantissa_size - places, &powers);
+      result.exponent -= digits;
+      free_powers(&powers);
+    }
+  }
+
+  free_bignum(&product_digits);
+  free_bignum(&power);
+  STATS_PHASE_END(PHASE_RADIX);
+  return result;
+}
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "headers/reference.h"
+
+bool reference_open(reference_file_t * file, const char * path) {
+  memset(file, 0, sizeof(*file));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "reference_open: %s could not be opened!\n", path);
+    return false;
+  }
+
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) || !S_ISREG(statbuf.st_mode)) {
+    fprintf(stderr, "reference_open: %s is not a regular file!\n", path);
+    close(fd);
+    return false;
+  }
+  if (0 == statbuf.st_size) { // Empty files can not be mapped, they have no digits.
+    close(fd);
+    file->data = "";
+    return true;
+  }
+
+  void * data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // The mapping stays valid without the file descriptor.
+  if (MAP_FAILED == data) {
+    fprintf(stderr, "reference_open: %s could not be mapped!\n", path);
+    return false;
+  }
+  madvise(data, statbuf.st_size, MADV_SEQUENTIAL); // Read ahead for files, that are not in the page cache.
+  file->data = data;
+  file->size = statbuf.st_size;
+  return true;
+}
+
+void reference_close(reference_file_t * file) {
+  if (file->size)
+    munmap((void *)file->data, file->size);
+  memset(file, 0, sizeof(*file));
+}
+
+/* Separators of the output layout and of downloaded digit files */
+static inline bool is_separator(char c) {
+  return (' ' == c) || ('\n' == c) || ('\r' == c) || ('\t' == c);
+}
+
+/*
+  Compares the digits of two texts like the output of the program, e.g. "1.4142...": separators (spaces and line
+  breaks) are skipped and letters are compared case insensitively, so the layouts of the texts may differ.
+  Equal runs of 16 characters are compared by SSE2 instructions, after a difference the texts are compared character
+  by character until the next digit, so texts with the same layout are compared at memory bandwidth.
+*/
+reference_match_t reference_compare(const char * first, size_t first_size, const char * second, size_t second_size) {
+  reference_match_t match = { .digits = 0, .mismatch = false, .first_ended = false, .second_ended = false };
+  size_t i = 0, j = 0;
+
+  while (true) {
+#ifdef __SSE2__
+    const __m128i fold = _mm_set1_epi8(0x20); // 'A' | 0x20 = 'a', digits and '.' are not changed.
+    const __m128i below_digits = _mm_set1_epi8('0' - 1); // Separators and '.' are below '0'.
+    while ((i + 16 <= first_size) && (j + 16 <= second_size)) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(first + i));
+      __m128i b = _mm_loadu_si128((const __m128i *)(second + j));
+      uint32_t equal = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(a, fold), _mm_or_si128(b, fold)));
+      uint32_t digits = _mm_movemask_epi8(_mm_cmpgt_epi8(a, below_digits));
+      if (0xFFFF == equal) {
+        match.digits += __builtin_popcount(digits);
+        i += 16;
+        j += 16;
+        continue;
+      }
+
+      /* The characters in front of the first difference are equal */
+      uint32_t length = __builtin_ctz(~equal);
+      match.digits += __builtin_popcount(digits & ((1u << length) - 1));
+      i += length;
+      j += length;
+      break;
+    }
+#endif
+
+    /* Next digit of both texts */
+    while ((i < first_size) && is_separator(first[i]))
+      ++i;
+    while ((j < second_size) && is_separator(second[j]))
+      ++j;
+    match.first_ended = (i >= first_size);
+    match.second_ended = (j >= second_size);
+    if (match.first_ended || match.second_ended)
+      return match;
+
+    if ((first[i] | 0x20) != (second[j] | 0x20)) {
+      match.mismatch = true;
+      return match;
+    }
+    match.digits += (first[i] >= '0');
+    ++i;
+    ++j;
+  }
+}
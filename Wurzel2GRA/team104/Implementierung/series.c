@@ -0,0 +1,341 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "headers/bignum.h"
+#include "headers/add_sub.h"
+#include "headers/div.h"
+#include "headers/mul.h"
+#include "headers/series.h"
+#include "headers/stats.h"
+#include "headers/wurzel.h"
+
+/* Intervals with at least PARALLEL_MIN_TERMS terms are split between the threads of the context */
+#define PARALLEL_MIN_TERMS (2048)
+
+/* Intervals with at most SUM_PQ_LEAF_TERMS terms are calculated by sum_pq_leaves */
+#define SUM_PQ_LEAF_TERMS (32)
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+/* Task of the thread pool for one half of the interval in sum_pq */
+typedef struct sum_pq_task_t {
+  pool_task_t task;
+  const pq_series_t * series;
+  uint32_t base;
+  size_t from, to, precision;
+  pq_series_result_t result;
+} sum_pq_task_t;
+
+/* Task of the thread pool for one product in sum_pq */
+typedef struct mul_task_t {
+  pool_task_t task;
+  struct bignum a, b, result;
+} mul_task_t;
+
+static void sum_pq_run(void * argument) {
+  sum_pq_task_t * task = argument;
+  task->result = sum_pq(task->series, task->base, task->from, task->to, task->precision);
+}
+
+static void mul_run(void * argument) {
+  mul_task_t * task = argument;
+  task->result = mul_bignum_karazuba(task->a, task->b);
+}
+
+/* 
+  Makes x a floating point bignum with at most 'precision' digits, if it is longer. 
+  Returns relative error caused by truncation in units of base ^ (1 - precision), i.e. 0 or 1.
+*/
+static uint64_t truncate_precision(struct bignum * x, size_t precision) {
+  if ((0 == precision) || (x->mantissa_size <= precision))
+    return 0;
+  truncate_mantissa(x, precision);
+  return 1;
+}
+
+/* Relative error of the product of two values with relative errors a and b (incl. second order term) */
+static uint64_t mul_error(uint64_t a, uint64_t b) {
+  return a + b + ((a && b) ? 1 : 0);
+}
+
+/*
+  Merges the values of two adjacent intervals [from, mid) and [mid, to) to the values of [from, to), see sum_pq.
+  Consumes low and high. If 'parallel' is set and the current context has a thread pool, two of the four products are 
+  calculated by the pool, while the calling thread works on the rest.
+*/
+pq_series_result_t sum_pq_merge(pq_series_result_t low, pq_series_result_t high, size_t precision, bool parallel) {
+  pq_series_result_t pq_series_result;
+  memset(&pq_series_result, 0, sizeof(pq_series_result));
+  thread_pool_t * pool = parallel ? context_current()->pool : NULL;
+  struct bignum lt_hq, lp_ht;
+
+  if (pool) {
+    mul_task_t p_task = { .a = low.p, .b = high.p };
+    mul_task_t q_task = { .a = low.q, .b = high.q };
+    p_task.task.function = q_task.task.function = mul_run;
+    p_task.task.argument = &p_task;
+    q_task.task.argument = &q_task;
+    pool_submit(pool, &p_task.task);
+    pool_submit(pool, &q_task.task);
+    lt_hq = mul_bignum_karazuba(low.t, high.q);
+    lp_ht = mul_bignum_karazuba(low.p, high.t);
+    pool_wait(pool, &p_task.task);
+    pool_wait(pool, &q_task.task);
+    pq_series_result.p = p_task.result;
+    pq_series_result.q = q_task.result;
+  } 
+  else {
+    pq_series_result.p = mul_bignum_karazuba(low.p, high.p);
+    pq_series_result.q = mul_bignum_karazuba(low.q, high.q);
+    lt_hq = mul_bignum_karazuba(low.t, high.q);
+    lp_ht = mul_bignum_karazuba(low.p, high.t);
+  }
+
+  /* All three values share one error bound: p and q are bounded by the bound for t */
+  uint64_t error = mul_error(low.error, high.error);
+  error += truncate_precision(&pq_series_result.p, precision);
+  error += truncate_precision(&pq_series_result.q, precision);
+  error += truncate_precision(&lt_hq, precision);
+  error += truncate_precision(&lp_ht, precision);
+
+  pq_series_result.t = add_bignum(lt_hq, lp_ht);
+  error += truncate_precision(&pq_series_result.t, precision);
+  pq_series_result.error = error;
+  
+  /* Memory deallocation of temporary results */
+  free_bignum(&lp_ht);
+  free_bignum(&lt_hq);
+  free_bignum(&high.t);
+  free_bignum(&high.q);
+  free_bignum(&high.p);
+  free_bignum(&low.t);
+  free_bignum(&low.q);
+  free_bignum(&low.p);
+  return pq_series_result;
+}
+
+/* Bignum with the value of a native 128-bit integer */
+static struct bignum bignum_uint128(uint128_t value, uint32_t base) {
+  if (value <= UINT64_MAX)
+    return bignum_uint64(value, base);
+
+  /* The lower 'chunk' digits are converted with 64-bit divisions, the upper part recursively */
+  uint64_t power = 1;
+  size_t chunk = 0;
+  while (power <= UINT64_MAX / base) {
+    power *= base;
+    ++chunk;
+  }
+  struct bignum high = bignum_uint128(value / power, base);
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  if (NULL == high.mantissa)
+    return high;
+
+  result.mantissa_size = chunk + high.mantissa_size;
+  result.deallocate = result.mantissa = bignum_calloc(result.mantissa_size, sizeof(result.mantissa[0]));
+  if (NULL == result.mantissa) {
+    if (!bignum_memory_exhausted()) // The exceeded memory limit was already reported
+      fprintf(stderr, "sum_pq: Memory allocation error!\n" "%" PRIu64 " bytes could not be allocated\n", result.mantissa_size);
+    free_bignum(&high);
+    return result;
+  }
+  uint64_t low = value % power;
+  for (size_t i = 0; i < chunk; ++i, low /= base)
+    result.mantissa[i] = low % base;
+  memcpy(result.mantissa + chunk, high.mantissa, high.mantissa_size);
+  result.exponent = result.mantissa_size;
+  result.base = base;
+  free_bignum(&high);
+  return result;
+}
+
+/*
+  Binary Splitting of a short interval without recursion: the terms are appended one by one to native 128-bit values
+  of P, Q and T (P' = P * p(k), Q' = Q * q(k), T' = T * q(k) + P * a(k) * p(k)) as long as they fit. Only then the
+  values are converted to bignums as one segment and a new segment is started. The segments are merged bottom-up.
+*/
+static pq_series_result_t sum_pq_leaves(const pq_series_t * series, uint32_t base, size_t from, size_t to, size_t precision) {
+  pq_series_result_t segments[SUM_PQ_LEAF_TERMS];
+  size_t count = 0;
+  bool success = true;
+
+  for (size_t k = from; k < to; ) {
+    uint128_t p = 1, q = 1, t = 0;
+    for ( ; k < to; ++k) {
+      uint64_t p_k = series->p(k), q_k = series->q(k);
+      uint128_t t_k = series->a ? (uint128_t)series->a(k) * p_k : p_k;
+      uint128_t next_p, next_q, next_t, t_q, p_t;
+      if (__builtin_mul_overflow(p, p_k, &next_p) || __builtin_mul_overflow(q, q_k, &next_q) ||
+          __builtin_mul_overflow(t, q_k, &t_q) || __builtin_mul_overflow(p, t_k, &p_t) || 
+          __builtin_add_overflow(t_q, p_t, &next_t))
+        break;
+      p = next_p;
+      q = next_q;
+      t = next_t;
+    }
+
+    pq_series_result_t * segment = &segments[count++];
+    segment->p = bignum_uint128(p, base);
+    segment->q = bignum_uint128(q, base);
+    segment->t = bignum_uint128(t, base);
+    segment->error = 0;
+    success = success && segment->p.mantissa && segment->q.mantissa && segment->t.mantissa;
+  }
+
+  for (size_t width = 1; width < count; width <<= 1) {
+    for (size_t i = 0; i + width < count; i += width << 1)
+      segments[i] = sum_pq_merge(segments[i], segments[i + width], precision, false);
+  }
+
+  if (!success) {
+    free_bignum(&segments[0].p);
+    free_bignum(&segments[0].q);
+    free_bignum(&segments[0].t);
+    memset(&segments[0], 0, sizeof(segments[0]));
+  }
+  return segments[0];
+}
+
+/* 
+  Binary Splitting: 
+  sum_pq calculates three values: P(from, to), Q(from, to), T(from, to) of 'series' in numerical base 'base'.
+  For an interval of one element k: P = p(k), Q = q(k), T = a(k) * p(k). Intervals of at most SUM_PQ_LEAF_TERMS terms
+  are calculated with native integers, see sum_pq_leaves.
+  sum_pq uses recurrent formula for calculation: 
+    P(from, to) = P(from, mid) * P(mid, to), 
+    Q(from, to) = Q(from, mid) * Q(mid, to),
+    T(from, to) = T(from, mid) * Q(mid, to) + P(from, mid) * T(mid, to).
+  If precision is not 0, all values longer than 'precision' digits are truncated to floating point bignums with 'precision'
+  significant digits. Every truncation adds at most base ^ (1 - precision) to the relative error of a value, the errors of 
+  the factors are summed up by multiplication. T is a sum of two positive values, so its relative error is not greater 
+  than the maximum of relative errors of both summands. The resulting bound is stored in pq_series_result.error.
+  If the current context has a thread pool, the lower half of large intervals and two of the four products are 
+  calculated by the pool, while the calling thread works on the rest (see sum_pq_merge).
+*/
+pq_series_result_t sum_pq(const pq_series_t * series, uint32_t base, size_t from, size_t to, size_t precision) {
+  pq_series_result_t pq_series_result;
+  memset(&pq_series_result, 0, sizeof(pq_series_result));
+  STATS_COUNT(OPERATION_SUM_PQ, to - from, to - from);
+
+  /* In case the memory limit was exceeded, the calculation is going to fail anyway */
+  if (bignum_memory_exhausted())
+    return pq_series_result;
+  
+  if (to - from <= SUM_PQ_LEAF_TERMS) { // Short intervals are calculated with native integers
+    pq_series_result = sum_pq_leaves(series, base, from, to, precision);
+  } 
+  else { // Main case: Description above
+    size_t mid = (from + to) >> 1;
+    thread_pool_t * pool = context_current()->pool;
+    bool parallel = pool && (to - from >= PARALLEL_MIN_TERMS);
+    pq_series_result_t low, high;
+
+    if (parallel) {
+      sum_pq_task_t low_task = { .series = series, .base = base, .from = from, .to = mid, .precision = precision };
+      low_task.task.function = sum_pq_run;
+      low_task.task.argument = &low_task;
+      pool_submit(pool, &low_task.task);
+      high = sum_pq(series, base, mid, to, precision);
+      pool_wait(pool, &low_task.task);
+      low = low_task.result;
+    } 
+    else {
+      low = sum_pq(series, base, from, mid, precision);
+      high = sum_pq(series, base, mid, to, precision);
+    }
+    pq_series_result = sum_pq_merge(low, high, precision, parallel);
+  }
+  return pq_series_result;
+}
+
+void sum_pq_state_clear(sum_pq_state_t * state) {
+  free_bignum(&state->value.p);
+  free_bignum(&state->value.q);
+  free_bignum(&state->value.t);
+  memset(state, 0, sizeof(*state));
+}
+
+/* Kept state of 'series' in numeral system 'base' in the context, a free slot if there is none, NULL if all are taken */
+static sum_pq_state_t * sum_pq_state(wurzel_context_t * context, const pq_series_t * series, uint32_t base) {
+  sum_pq_state_t * free_slot = NULL;
+  for (int i = 0; i < SUM_PQ_STATES; ++i) {
+    sum_pq_state_t * state = &context->splitting_state[i];
+    if ((state->series == series) && (state->base == base))
+      return state;
+    if ((NULL == state->series) && (NULL == free_slot))
+      free_slot = state;
+  }
+  if (free_slot) {
+    free_slot->series = series;
+    free_slot->base = base;
+  }
+  return free_slot;
+}
+
+/*
+  Sum of the terms 1 .. terms - 1 of a series with 0 <= S < 1 as T / Q with 'digits' places after the point in numeral 
+  system 'base'. Binary Splitting is done as configured in the current context:
+  - truncated_splitting: T / Q < 1, so its absolute error is less than (error(T) + error(Q)) * base ^ (1 - precision).
+    It has to stay below base ^ -digits -> guard digits are added until the tracked error bound fits into them.
+  - keep_splitting_state: the kept state of [1, to) of the series is extended by [to, terms) only. A state with more
+    terms is used as it is, since the remainder of the series only gets smaller. Truncated values can't be extended.
+  - otherwise P, Q and T are calculated exactly.
+*/
+struct bignum sum_series(const pq_series_t * series, uint32_t base, size_t terms, size_t digits) {
+  wurzel_context_t * context = context_current();
+  pq_series_result_t pq_series_result;
+  sum_pq_state_t * state = NULL;
+
+  STATS_PHASE_BEGIN(PHASE_SUM_PQ);
+  if (context->truncated_splitting) {
+    size_t guard_digits = 2;
+    uint64_t guard = base * base;
+    while (true) {
+      pq_series_result = sum_pq(series, base, 1, terms, digits + 1 + guard_digits);
+      if ((pq_series_result.error << 1) < guard)
+        break;
+
+      free_bignum(&pq_series_result.p);
+      free_bignum(&pq_series_result.q);
+      free_bignum(&pq_series_result.t);
+      while ((pq_series_result.error << 1) >= guard) {
+        guard *= base;
+        ++guard_digits;
+      }
+    }
+  } 
+  else if (context->keep_splitting_state && (state = sum_pq_state(context, series, base))) {
+    if (0 == state->to) {
+      state->value = sum_pq(series, base, 1, terms, 0);
+      state->to = terms;
+    } 
+    else if (state->to < terms) {
+      pq_series_result_t extension = sum_pq(series, base, state->to, terms, 0);
+      state->value = sum_pq_merge(state->value, extension, 0, true);
+      state->to = terms;
+    }
+    pq_series_result = state->value;
+
+    /* In case of an error the state is dropped, the calculation fails below */
+    if ((NULL == state->value.p.mantissa) || (NULL == state->value.q.mantissa) || (NULL == state->value.t.mantissa)) {
+      sum_pq_state_clear(state);
+      memset(&pq_series_result, 0, sizeof(pq_series_result));
+    }
+  } 
+  else {
+    pq_series_result = sum_pq(series, base, 1, terms, 0);
+  }
+  STATS_PHASE_END(PHASE_SUM_PQ);
+
+  struct bignum sum = div_bignum(pq_series_result.t, pq_series_result.q, digits);
+  if (NULL == state) { // Kept values belong to the context.
+    free_bignum(&pq_series_result.p);
+    free_bignum(&pq_series_result.q);
+    free_bignum(&pq_series_result.t);
+  }
+  return sum;
+}
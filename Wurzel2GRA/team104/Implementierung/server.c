@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "headers/server.h"
+
+/* Connection of a client: input and output are equal for sockets, stdin and stdout otherwise */
+typedef struct connection_t {
+  int input, output;
+  char buffer[SERVER_LINE_LENGTH]; // Begin of a line, that is not complete yet.
+  size_t used;
+  bool closed; // End of input reached or error, the connection is closed after the batch.
+} connection_t;
+
+/* Request of a batch, error is NULL for valid requests */
+typedef struct request_t {
+  connection_t * connection;
+  numeral_system_t base;
+  size_t digits;
+  version_t version;
+  const char * error;
+} request_t;
+
+/* Batch of requests, that arrived while the previous batch was calculated */
+typedef struct batch_t {
+  request_t * requests;
+  size_t count, capacity;
+} batch_t;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int signal_number) {
+  (void)signal_number;
+  stop_requested = 1;
+}
+
+/* Writes all bytes, false in case of errors (e.g. the client is gone) */
+static bool write_all(int fd, const char * data, size_t length) {
+  while (length > 0) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    length -= written;
+  }
+  return true;
+}
+
+static void answer(connection_t * connection, const char * line) {
+  if (!write_all(connection->output, line, strlen(line)) || !write_all(connection->output, "\n", 1))
+    connection->closed = true;
+}
+
+/* Parser for request lines "<base> <digits> [<version>]" */
+static void parse_request(char * line, request_t * request) {
+  unsigned long base, version = VERSION_0;
+  unsigned long long digits;
+  char rest;
+  int fields = sscanf(line, "%lu %llu %lu %c", &base, &digits, &version, &rest);
+
+  if ((fields < 2) || (fields > 3) || strchr(line, '-')) {
+    request->error = "ERROR invalid request, expected: <base> <digits> [<version>]";
+  } else if ((base != 10) && (base != 16)) {
+    request->error = "ERROR base must be 10 or 16";
+  } else if (digits > BIGNUM_MAX_DIGITS) {
+    request->error = "ERROR too many digits";
+  } else if (version > VERSION_3) {
+    request->error = "ERROR version must be 0, 1, 2 or 3";
+  } else {
+    request->base = (base == 10) ? DECIMAL : HEXADECIMAL;
+    request->digits = digits;
+    request->version = version;
+  }
+}
+
+static bool batch_add(batch_t * batch, request_t request) {
+  if (batch->count == batch->capacity) {
+    size_t capacity = batch->capacity ? (batch->capacity << 1) : 16;
+    request_t * requests = realloc(batch->requests, capacity * sizeof(requests[0]));
+    if (NULL == requests) {
+      fprintf(stderr, "server: Memory allocation error!\n");
+      return false;
+    }
+    batch->requests = requests;
+    batch->capacity = capacity;
+  }
+  batch->requests[batch->count++] = request;
+  return true;
+}
+
+/* Reads available input of a connection and adds its complete lines to the batch */
+static void read_requests(connection_t * connection, batch_t * batch) {
+  ssize_t length = read(connection->input, connection->buffer + connection->used, sizeof(connection->buffer) - connection->used);
+  if (length <= 0) {
+    if ((length < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+      return;
+    connection->closed = true;
+    return;
+  }
+  connection->used += length;
+
+  char * line = connection->buffer;
+  char * end;
+  while ((end = memchr(line, '\n', connection->buffer + connection->used - line))) {
+    *end = 0;
+    request_t request = { .connection = connection, .error = NULL };
+    parse_request(line, &request);
+    if (!batch_add(batch, request))
+      connection->closed = true;
+    line = end + 1;
+  }
+
+  connection->used -= line - connection->buffer;
+  memmove(connection->buffer, line, connection->used);
+  if (connection->used == sizeof(connection->buffer)) {
+    answer(connection, "ERROR request line too long");
+    connection->closed = true;
+  }
+}
+
+/*
+  Answers all requests of the batch: one calculation per numeral system with the largest requested precision, all
+  requests are then served by the result cache of the context.
+*/
+static void serve_batch(wurzel_context_t * context, batch_t * batch) {
+  size_t max_digits[HEXADECIMAL + 1] = { 0 };
+  version_t max_version[HEXADECIMAL + 1] = { VERSION_0, VERSION_0 };
+  bool requested[HEXADECIMAL + 1] = { false };
+  bool calculated[HEXADECIMAL + 1] = { false };
+
+  for (size_t i = 0; i < batch->count; ++i) {
+    request_t * request = &batch->requests[i];
+    if (request->error)
+      continue;
+    if (!requested[request->base] || (request->digits > max_digits[request->base])) {
+      max_digits[request->base] = request->digits;
+      max_version[request->base] = request->version;
+    }
+    requested[request->base] = true;
+  }
+
+  for (int base = DECIMAL; base <= HEXADECIMAL; ++base) {
+    if (!requested[base])
+      continue;
+    struct bignum x = wurzel_sqrt2(context, max_digits[base], base, max_version[base]);
+    calculated[base] = (NULL != x.mantissa);
+    free_bignum(&x);
+  }
+
+  for (size_t i = 0; i < batch->count; ++i) {
+    request_t * request = &batch->requests[i];
+    if (request->error) {
+      answer(request->connection, request->error);
+      continue;
+    }
+    if (!calculated[request->base]) {
+      answer(request->connection, "ERROR calculation failed");
+      continue;
+    }
+
+    struct bignum x = wurzel_sqrt2(context, request->digits, request->base, request->version);
+    char * result = (NULL != x.mantissa) ? wurzel_format(context, x, request->digits) : NULL;
+    answer(request->connection, result ? result : "ERROR calculation failed");
+    free(result);
+    free_bignum(&x);
+  }
+  batch->count = 0;
+}
+
+/* Socket of the server at 'path', a stale socket file is replaced. -1 in case of errors */
+static int listen_socket(const char * path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "server: Socket path %s is too long!\n", path);
+    return -1;
+  }
+  strcpy(address.sun_path, path);
+
+  struct stat statbuf;
+  if ((0 == stat(path, &statbuf)) && S_ISSOCK(statbuf.st_mode))
+    unlink(path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ((fd < 0) || bind(fd, (struct sockaddr *)&address, sizeof(address)) || listen(fd, SERVER_MAX_CONNECTIONS)) {
+    fprintf(stderr, "server: Socket %s could not be opened: %s\n", path, strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/*
+  Main loop of the server: waits for input of all connections (and new connections to the socket), collects all complete
+  request lines to a batch and answers it. Ends on SIGINT or SIGTERM, with stdin also at the end of the input.
+*/
+bool server_run(wurzel_context_t * context, const char * socket_path) {
+  context->cache_results = true;
+  context->keep_splitting_state = true;
+  context->group_digits = context->line_digits = 0; // Every answer is one line.
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = handle_signal; // Without SA_RESTART, so that poll is interrupted.
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  signal(SIGPIPE, SIG_IGN); // Clients, that are gone, are detected by failing writes.
+
+  int listener = -1;
+  connection_t * connections[SERVER_MAX_CONNECTIONS];
+  int connection_count = 0;
+  batch_t batch = { .requests = NULL, .count = 0, .capacity = 0 };
+  bool success = true;
+
+  if (socket_path) {
+    listener = listen_socket(socket_path);
+    if (listener < 0)
+      return false;
+    fprintf(stderr, "Server listening on %s\n", socket_path);
+  } else {
+    connections[connection_count] = calloc(1, sizeof(connection_t));
+    if (NULL == connections[connection_count]) {
+      fprintf(stderr, "server: Memory allocation error!\n");
+      return false;
+    }
+    connections[connection_count]->input = STDIN_FILENO;
+    connections[connection_count++]->output = STDOUT_FILENO;
+  }
+
+  while (!stop_requested && ((listener >= 0) || (connection_count > 0))) {
+    struct pollfd fds[SERVER_MAX_CONNECTIONS + 1];
+    int first = 0;
+    if (listener >= 0)
+      fds[first++] = (struct pollfd) { .fd = listener, .events = POLLIN };
+    for (int i = 0; i < connection_count; ++i)
+      fds[first + i] = (struct pollfd) { .fd = connections[i]->input, .events = POLLIN };
+
+    if (poll(fds, first + connection_count, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "server: poll failed: %s\n", strerror(errno));
+      success = false;
+      break;
+    }
+
+    /* Input of all connections, that arrived so far, forms the batch */
+    int polled_count = connection_count;
+    for (int i = 0; i < polled_count; ++i) {
+      if (fds[first + i].revents)
+        read_requests(connections[i], &batch);
+    }
+
+    if ((listener >= 0) && (fds[0].revents & POLLIN)) {
+      int fd = accept(listener, NULL, NULL);
+      connection_t * connection = (fd >= 0) && (connection_count < SERVER_MAX_CONNECTIONS) ? calloc(1, sizeof(*connection)) : NULL;
+      if (connection) {
+        connection->input = connection->output = fd;
+        connections[connection_count++] = connection;
+      } else if (fd >= 0) {
+        close(fd);
+      }
+    }
+
+    serve_batch(context, &batch);
+
+    /* Closed connections are removed after their requests were answered */
+    for (int i = 0; i < connection_count; ) {
+      if (connections[i]->closed) {
+        if (listener >= 0)
+          close(connections[i]->input);
+        free(connections[i]);
+        connections[i] = connections[--connection_count];
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  for (int i = 0; i < connection_count; ++i) {
+    if (listener >= 0)
+      close(connections[i]->input);
+    free(connections[i]);
+  }
+  if (listener >= 0) {
+    close(listener);
+    unlink(socket_path);
+  }
+  free(batch.requests);
+  return success;
+}
+
+/* Simple client: lines of stdin are sent to the server, its answers are printed to stdout */
+bool client_run(const char * socket_path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(socket_path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "client: Socket path %s is too long!\n", socket_path);
+    return false;
+  }
+  strcpy(address.sun_path, socket_path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ((fd < 0) || connect(fd, (struct sockaddr *)&address, sizeof(address))) {
+    fprintf(stderr, "client: Connection to %s failed: %s\n", socket_path, strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  struct pollfd fds[2] = {
+    { .fd = STDIN_FILENO, .events = POLLIN },
+    { .fd = fd, .events = POLLIN },
+  };
+  char buffer[4096];
+  bool success = true;
+  while (true) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      success = false;
+      break;
+    }
+
+    if (fds[0].revents) {
+      ssize_t length = read(STDIN_FILENO, buffer, sizeof(buffer));
+      if ((length <= 0) || !write_all(fd, buffer, length)) {
+        shutdown(fd, SHUT_WR); // The server answers the remaining requests and closes the connection.
+        fds[0].fd = -1;
+      }
+    }
+
+    if (fds[1].revents) {
+      ssize_t length = read(fd, buffer, sizeof(buffer));
+      if (length <= 0)
+        break;
+      if (!write_all(STDOUT_FILENO, buffer, length)) {
+        success = false;
+        break;
+      }
+    }
+  }
+  close(fd);
+  return success;
+}
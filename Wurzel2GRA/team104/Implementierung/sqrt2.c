@@ -7,55 +7,30 @@
 
 #include "headers/bignum.h"
 #include "headers/div.h"
+#include "headers/fixed.h"
 #include "headers/mul.h"
 #include "headers/sqrt2.h"
+#include "headers/stats.h"
+#include "headers/wurzel.h"
 
-/* Structure to store P(n1,n2), Q(n1, n2), T(n1, n2). All values are Integer. */
-typedef struct pq_series_result_t {
-  struct bignum p, q, t;
-} pq_series_result_t;
+/* Leaf terms of the series for root of 2: p(k) = 2k - 1, q(k) = 4k, a(k) = 1 */
+static uint64_t sqrt2_p(size_t k) {
+  return (k << 1) - 1;
+}
+
+static uint64_t sqrt2_q(size_t k) {
+  return k << 2;
+}
 
 /* 
-  Binary Splitting: 
-  sum_pq calculates three values: P(from, to), Q(from, to), T(from, to) in numerical base 'base'.
-  sum_pq uses recurrent formula for calculation: 
-    P(from, to) = P(from, mid) * P(mid, to), 
-    Q(from, to) = Q(from, mid) * Q(mid, to),
-    T(from, to) = T(from, mid) * Q(mid, to) + P(from, mid) * T(mid, to).
+  Series for root of 2 = 1 + sum_{k >= 1} prod_{j <= k} (2j - 1) / (4j), from the Taylor series of (1 - x) ^ (-1/2) 
+  at x = 1/2. Every term contributes at least one binary digit.
 */
-pq_series_result_t sum_pq(uint32_t base, size_t from, size_t to) {
-  pq_series_result_t pq_series_result;
-  memset(&pq_series_result, 0, sizeof(pq_series_result));
-  
-  if (to - from == 1) { // Edge case: Interval consists of one element
-    pq_series_result.p = bignum_uint64((from << 1) - 1, base); // p(from) = 2 * from - 1
-    pq_series_result.q = bignum_uint64(from << 2, base); // q(from) = 4 * from
-    pq_series_result.t = bignum_uint64((from << 1) - 1, base); // t(from) = 1 * p(from)
-  } 
-  else { // Main case: Description above
-    size_t mid = (from + to) >> 1;
-    pq_series_result_t low = sum_pq(base, from, mid);
-    pq_series_result_t high = sum_pq(base, mid, to);
-
-    pq_series_result.p = mul_bignum_karazuba(low.p, high.p);
-    pq_series_result.q = mul_bignum_karazuba(low.q, high.q);
-    struct bignum lt_hq = mul_bignum_karazuba(low.t, high.q);
-    struct bignum lp_ht = mul_bignum_karazuba(low.p, high.t);
-
-    pq_series_result.t = add_bignum(lt_hq, lp_ht);
-    
-    /* Memory deallocation of temporary results */
-    free_bignum(&lp_ht);
-    free_bignum(&lt_hq);
-    free_bignum(&high.t);
-    free_bignum(&high.q);
-    free_bignum(&high.p);
-    free_bignum(&low.t);
-    free_bignum(&low.q);
-    free_bignum(&low.p);
-  }
-  return pq_series_result;
-}
+const pq_series_t sqrt2_series = {
+  .p = sqrt2_p,
+  .q = sqrt2_q,
+  .a = NULL,
+};
 
 /* 
   Hauptimplementierung:
@@ -79,99 +54,232 @@ struct bignum sqrt2(size_t s, numeral_system_t base) {
   }
   
   /* Calculation of the formula given in the Aufgabenstellung */
-  pq_series_result_t pq_series_result = sum_pq(numeral_system_base, 1, binary_digits);
-  struct bignum fractional = div_bignum(pq_series_result.t, pq_series_result.q, s + 1);
+  struct bignum fractional = sum_series(&sqrt2_series, numeral_system_base, binary_digits, s + 1);
+  STATS_PHASE_BEGIN(PHASE_FINAL_ADD);
   struct bignum one = bignum_uint64(1, numeral_system_base);
   struct bignum sqrt2_value = add_bignum(one, fractional);
+  STATS_PHASE_END(PHASE_FINAL_ADD);
 
   /* Memory deallocation of temporary results */
   free_bignum(&one);
   free_bignum(&fractional);
-  free_bignum(&pq_series_result.p);
-  free_bignum(&pq_series_result.q);
-  free_bignum(&pq_series_result.t);
 
   return sqrt2_value;
 }
 
-/* Constant value 2 */
-static struct bignum two = {
-  .mantissa_size = 1,
-  .deallocate = NULL,
-  .mantissa = (uint8_t[]) { 2 },
-  .negative = false,
-  .exponent = 1,
-};
-
-/* Constant value 1/2 to the given base */
-static struct bignum half_base = {
-  .mantissa_size = 1,
-  .deallocate = NULL,
-  .mantissa = (uint8_t[]) { 0 },
-  .negative = false,
-  .exponent = 0,
-};
-
 struct bignum sqrt2_V2(size_t s, numeral_system_t base) {
   s = (s < 5) ? 5 : s;
   size_t bignum_digits = s + 1;
   uint32_t numeral_system_base = (base == DECIMAL) ? 10 : 0x10;
-  two.base = numeral_system_base;
-  half_base.base = numeral_system_base;
-  half_base.mantissa[0] = numeral_system_base >> 1;
+
+  /* Constant value 2 */
+  struct bignum two = {
+    .mantissa_size = 1,
+    .deallocate = NULL,
+    .mantissa = (uint8_t[]) { 2 },
+    .base = numeral_system_base,
+    .negative = false,
+    .exponent = 1,
+  };
 
   /* 
     Target function: f(x) = x ^ 2 - 2.
     next = prev - f(prev) / f'(prev) = prev - ((prev^2 - 2) / (2 * prev)) = prev + 1/2(2/prev - prev)
+    All approximations are in [1, 2), so they are fixed-point numbers with one place in front of the point and 
+    expected_accuracy + FIXED_GUARD_DIGITS places after it.
   */
 
   size_t expected_accuracy = 2;
 
   /* Initial guess: 1 */
-  struct bignum sqrt2_value = bignum_uint64(1, numeral_system_base);
-
-  while(true) {
-    struct bignum two_div_sqrt2_value = div_bignum(two, sqrt2_value, expected_accuracy);
-    struct bignum double_residual = sub_bignum(two_div_sqrt2_value, sqrt2_value);
-    struct bignum residual =  mul_bignum_karazuba(half_base, double_residual);
-    struct bignum next_approximation = add_bignum(sqrt2_value, residual);
+  fixed_t sqrt2_value = fixed_uint64(1, 1, expected_accuracy + FIXED_GUARD_DIGITS, numeral_system_base);
 
-    bool residual_is_zero = (1 == residual.mantissa_size) && (0 == residual.mantissa[0]);
+  /* 
+    Reciprocal of sqrt2_value from the previous division. It is accurate to about twice the places of the previous 
+    step, so every division refines it by one or two Newton steps instead of starting again from 1.
+  */
+  struct bignum reciprocal;
+  memset(&reciprocal, 0, sizeof(reciprocal));
+  bool success = (NULL != sqrt2_value.digits);
 
-    /* Memory deallocation of temporary results */
+  STATS_PHASE_BEGIN(PHASE_NEWTON);
+  while (success) {
+    struct bignum two_div_sqrt2_value = div_bignum_reciprocal(two, fixed_view(sqrt2_value), expected_accuracy, &reciprocal);
+    fixed_t residual = fixed_from_bignum(two_div_sqrt2_value, 1, sqrt2_value.fraction);
     free_bignum(&two_div_sqrt2_value);
-    free_bignum(&double_residual);
-    free_bignum(&residual);
-    free_bignum(&sqrt2_value);
-
-    sqrt2_value = next_approximation;
 
     /* Checking whether all arithmetic calculations went well */
-    if (NULL == sqrt2_value.mantissa)
-      return sqrt2_value;
+    success = sub_fixed(&residual, residual, sqrt2_value);
+    if (success) {
+      half_fixed(&residual);
+      success = add_fixed(&sqrt2_value, sqrt2_value, residual);
+    }
+    bool residual_is_zero = success && fixed_is_zero(residual);
+    int64_t residual_exponent = success ? fixed_exponent(residual) : 0;
 
-    if (residual_is_zero || -(residual.exponent) > (int32_t)bignum_digits + 4)
+    /* Memory deallocation of temporary results */
+    free_fixed(&residual);
+
+    if (!success || residual_is_zero || -residual_exponent > (int64_t)bignum_digits + 4)
       break;
 
    /* expected_accuracy is chosen in a way, that 2 / sqrt2_value results with accurate number of decimal digits */
-    expected_accuracy = 4 - (residual.exponent << 1);
-
-    //fprintf (stderr, "exp = %d expecetd = %zd\n", residual.exponent, expected_accuracy);
+    expected_accuracy = 4 - (residual_exponent << 1);
+    success = resize_fixed(&sqrt2_value, expected_accuracy + FIXED_GUARD_DIGITS);
   }
-  truncate_mantissa(&sqrt2_value, bignum_digits);
-  return sqrt2_value;
+  STATS_PHASE_END(PHASE_NEWTON);
+  free_bignum(&reciprocal);
+  if (!success) {
+    free_fixed(&sqrt2_value);
+    struct bignum result;
+    memset(&result, 0, sizeof(result));
+    return result;
+  }
+
+  struct bignum result = fixed_to_bignum(&sqrt2_value);
+  truncate_mantissa(&result, bignum_digits);
+  return result;
 }
 
 /* 
-  Global variable to indicate usage of vectorised multiplication in Karazuba for VERSION_2.
-  Otherwise alternative realisation with, for example, change of signature required larger amount of code and considered less concised.
+  Alternativ implementation (VERSION_1) with usage of vectorized multiplication. 
+  The flag for vectorised multiplication in Karazuba is set in the current context for this calculation only.
 */
-bool vectorised;
+struct bignum sqrt2_V1(size_t s, numeral_system_t base)  {
+  wurzel_context_t * context = context_current();
+  bool vectorised = context->vectorised;
+  context->vectorised = true;
+  struct bignum result = sqrt2(s, base);
+  context->vectorised = vectorised;
+  return result;
+}
 
-/* 
-  Alternativ implementation (VERSION_2) with usage of vectorized multiplication. 
+/*
+  One step of the third order iteration for y = 1 / root of 2 (Householder), with multiplications only:
+  h = 1 - 2 * y ^ 2, next = y + y * (h / 2 + 3/8 * h ^ 2). The relative error of next is about 5/16 * h ^ 3, so every
+  step triples the correct places. All values are fixed-point numbers with the places of y.
+  Returns false in case of errors, *h is set to the value of h before the step.
 */
-struct bignum sqrt2_V1(size_t s, numeral_system_t base)  {
-  vectorised = true;
-  return sqrt2(s, base);
+static bool householder_step(fixed_t * y, fixed_t * h) {
+  fixed_t one = fixed_uint64(1, 1, y->fraction, y->base);
+  fixed_t h_sqr = fixed_uint64(0, 1, y->fraction, y->base);
+  *h = fixed_uint64(0, 1, y->fraction, y->base);
+
+  bool success = mul_fixed(h, *y, *y) && add_fixed(h, *h, *h) && sub_fixed(h, one, *h);
+  if (success && !fixed_is_zero(*h)) {
+    /* correction = h / 2 + (3 * h ^ 2) / 8 */
+    fixed_t correction = fixed_uint64(0, 1, y->fraction, y->base);
+    success = mul_fixed(&h_sqr, *h, *h) && add_fixed(&correction, h_sqr, h_sqr) && add_fixed(&correction, correction, h_sqr);
+    if (success) {
+      half_fixed(&correction);
+      half_fixed(&correction);
+      success = add_fixed(&correction, correction, *h);
+      half_fixed(&correction);
+    }
+    success = success && mul_fixed(&correction, *y, correction) && add_fixed(y, *y, correction);
+    free_fixed(&correction);
+  }
+
+  free_fixed(&one);
+  free_fixed(&h_sqr);
+  return success;
+}
+
+/*
+  Alternative implementation (VERSION_3): root of 2 = 2 / root of 2 = 2 * y with y = 1 / root of 2 by the third order 
+  iteration of householder_step, without any division. A step, that starts with k correct places, is calculated with 
+  3 * k places plus guard places, since it triples the correct places. The iteration ends, after a step with all 
+  places gave at least s + 6 correct places.
+*/
+struct bignum sqrt2_V3(size_t s, numeral_system_t base) {
+  s = (s < 5) ? 5 : s;
+  uint32_t numeral_system_base = (base == DECIMAL) ? 10 : 0x10;
+  size_t max_fraction = s + 6 + FIXED_GUARD_DIGITS;
+
+  /* Initial guess: largest d / base <= 1 / root of 2, correct to one place */
+  uint8_t guess = 1;
+  while (2 * (guess + 1) * (guess + 1) <= numeral_system_base * numeral_system_base)
+    ++guess;
+  struct bignum guess_value = { .mantissa = &guess, .mantissa_size = 1, .exponent = 0, .base = numeral_system_base };
+  size_t correct = 1;
+  size_t fraction = (3 * correct + FIXED_GUARD_DIGITS < max_fraction) ? 3 * correct + FIXED_GUARD_DIGITS : max_fraction;
+  fixed_t y = fixed_from_bignum(guess_value, 1, fraction);
+  bool success = (NULL != y.digits);
+
+  STATS_PHASE_BEGIN(PHASE_HOUSEHOLDER);
+  while (success) {
+    fixed_t h;
+    success = householder_step(&y, &h);
+    bool h_is_zero = success && fixed_is_zero(h);
+    int64_t h_exponent = success ? fixed_exponent(h) : 0;
+    free_fixed(&h);
+    if (!success)
+      break;
+
+    /* y had about -h_exponent correct places, the step tripled them as far as the places of y allow */
+    correct = (h_is_zero || (-3 * h_exponent >= (int64_t)max_fraction)) ? max_fraction : (size_t)(-3 * h_exponent);
+    if ((correct >= s + 6) && (fraction >= max_fraction))
+      break;
+
+    fraction = (3 * correct + FIXED_GUARD_DIGITS < max_fraction) ? 3 * correct + FIXED_GUARD_DIGITS : max_fraction;
+    success = resize_fixed(&y, fraction);
+  }
+  STATS_PHASE_END(PHASE_HOUSEHOLDER);
+
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+  if (success && add_fixed(&y, y, y)) {
+    result = fixed_to_bignum(&y);
+    truncate_mantissa(&result, s + 1);
+  }
+  free_fixed(&y);
+  return result;
+}
+
+/*
+  Self-verification of the result without reference values: 
+  x is the value with 'digits' places after the point, that is printed (the rest is cut off), ulp = base ^ (-digits).
+  x is correct, if x ^ 2 <= 2 < (x + ulp) ^ 2 <=> 0 <= 2 - x ^ 2 < 2 * x * ulp + ulp ^ 2.
+  Costs one squaring of x, which is a fraction of the calculation itself.
+*/
+bool verify_sqrt2(struct bignum x, size_t digits) {
+  if ((NULL == x.mantissa) || (0 == x.mantissa_size))
+    return false;
+
+  normalize(&x);
+  if (x.negative || x.exponent < 1)
+    return false;
+  STATS_PHASE_BEGIN(PHASE_VERIFY);
+
+  /* Cutting off all positions, that are not printed */
+  if (x.mantissa_size > x.exponent + digits) {
+    x.mantissa += x.mantissa_size - (x.exponent + digits);
+    x.mantissa_size = x.exponent + digits;
+  }
+
+  struct bignum two = bignum_uint64(2, x.base);
+
+  struct bignum x_sqr = sqr_bignum_karazuba(x);
+  struct bignum residual = sub_bignum(two, x_sqr); // 2 - x ^ 2
+  struct bignum ulp_sqr = bignum_uint64(1, x.base);
+  ulp_sqr.exponent -= digits << 1;
+  struct bignum double_x = add_bignum(x, x);
+  double_x.exponent -= digits; // 2 * x * ulp
+  struct bignum bound = add_bignum(double_x, ulp_sqr); // 2 * x * ulp + ulp ^ 2
+  struct bignum bound_sub_residual = sub_bignum(bound, residual);
+
+  bool verified = (NULL != residual.mantissa) && (NULL != bound_sub_residual.mantissa) && !residual.negative
+    && !bound_sub_residual.negative && !((1 == bound_sub_residual.mantissa_size) && (0 == bound_sub_residual.mantissa[0]));
+
+  /* Memory deallocation of temporary results */
+  free_bignum(&bound_sub_residual);
+  free_bignum(&bound);
+  free_bignum(&double_x);
+  free_bignum(&ulp_sqr);
+  free_bignum(&residual);
+  free_bignum(&x_sqr);
+  free_bignum(&two);
+  STATS_PHASE_END(PHASE_VERIFY);
+
+  return verified;
 }
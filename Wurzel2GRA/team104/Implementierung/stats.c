@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "headers/stats.h"
+#include "headers/wurzel.h"
+
+/* Events of the counters, same order as in perf_counter_t */
+static const struct {
+  uint32_t type;
+  uint64_t config;
+  const char * name;
+} perf_events[PERF_COUNTER_COUNT] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache misses" },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch misses" },
+  { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page faults" },
+};
+
+/* File descriptors of the counters, -1 if not available. They count the whole process and stay open until its end */
+static int perf_fds[PERF_COUNTER_COUNT] = { -1, -1, -1, -1, -1 };
+static bool perf_enabled = false;
+
+/*
+  Opens one counter per event for the calling thread and all threads created later (inherit), user space only, so that
+  perf_event_paranoid <= 2 is enough. Events, that are not available (e.g. hardware counters in virtual machines), are
+  reported and skipped. Returns false, if no counter could be opened.
+*/
+bool stats_perf_open(void) {
+  char missing[256] = "";
+  int error = 0;
+  for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = perf_events[i].type;
+    attr.config = perf_events[i].config;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    if (perf_fds[i] < 0) {
+      error = errno;
+      snprintf(missing + strlen(missing), sizeof(missing) - strlen(missing), "%s%s", missing[0] ? ", " : "", perf_events[i].name);
+    } else {
+      perf_enabled = true;
+    }
+  }
+  if (missing[0])
+    fprintf(stderr, "Performance counters not available: %s (%s, see /proc/sys/kernel/perf_event_paranoid)\n", missing, strerror(error));
+  return perf_enabled;
+}
+
+/* Current values of all counters, scaled up, if the kernel had to multiplex them */
+static void perf_read(uint64_t values[PERF_COUNTER_COUNT]) {
+  for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+    uint64_t data[3] = { 0, 0, 0 }; // value, time enabled, time running
+    values[i] = 0;
+    if ((perf_fds[i] >= 0) && (sizeof(data) == read(perf_fds[i], data, sizeof(data))))
+      values[i] = ((data[2] > 0) && (data[2] < data[1])) ? (uint64_t)((double)data[0] * data[1] / data[2]) : data[0];
+  }
+}
+
+static double clock_seconds(clockid_t clock) {
+  struct timespec time;
+  clock_gettime(clock, &time);
+  return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+
+void stats_count(stats_operation_t operation, uint64_t digits, uint64_t work) {
+  operation_stats_t * operations = context_current()->stats.operations;
+  __atomic_fetch_add(&operations[operation].calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&operations[operation].digits, digits, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&operations[operation].work, work, __ATOMIC_RELAXED);
+}
+
+void stats_phase_begin(stats_phase_t phase) {
+  phase_stats_t * phases = context_current()->stats.phases;
+  if (0 == phases[phase].depth++) {
+    phases[phase].wall_start = clock_seconds(CLOCK_MONOTONIC);
+    phases[phase].cpu_start = clock_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    if (perf_enabled)
+      perf_read(phases[phase].counters_start);
+    ++phases[phase].calls;
+  }
+}
+
+void stats_phase_end(stats_phase_t phase) {
+  phase_stats_t * phases = context_current()->stats.phases;
+  if (0 == --phases[phase].depth) {
+    phases[phase].wall += clock_seconds(CLOCK_MONOTONIC) - phases[phase].wall_start;
+    phases[phase].cpu += clock_seconds(CLOCK_PROCESS_CPUTIME_ID) - phases[phase].cpu_start;
+    if (perf_enabled) {
+      uint64_t counters[PERF_COUNTER_COUNT];
+      perf_read(counters);
+      for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+        phases[phase].counters[i] += counters[i] - phases[phase].counters_start[i];
+    }
+  }
+}
+
+void stats_reset(stats_t * stats) {
+  memset(stats, 0, sizeof(*stats));
+}
+
+#ifdef WURZEL_STATS
+/* Names for the report, same order as in stats_phase_t and stats_operation_t */
+static const char * phase_names[PHASE_COUNT] = {
+  "sum_pq", "div_bignum (reciprocal)", "div_bignum (multiply)", "sqrt2_V2 (Newton)", "final add", "build_string",
+  "output", "verify", "radix conversion", "div_bignum (exact)", "sqrt2_V3 (Householder)",
+};
+
+static const char * operation_names[OPERATION_COUNT] = {
+  "add_bignum", "sub_bignum", "mul_bignum_V0", "mul_bignum_V1", "mul_bignum_karazuba", "sqr_bignum_karazuba",
+  "div_bignum", "sum_pq", "divmod_bignum",
+};
+#endif
+
+/*
+  Report for --stats: wall and CPU time per phase, calls and operand digits per routine and the share of the
+  multiplication work (digit products) handled by each tier of multiplication.
+*/
+void stats_report(stats_t * stats, FILE * file) {
+#ifndef WURZEL_STATS
+  (void)stats;
+  fprintf(file, "Statistics were disabled at compile time (make STATS=0)\n");
+#else
+  phase_stats_t * phases = stats->phases;
+  operation_stats_t * operations = stats->operations;
+  fprintf(file, "\n%-26s %10s %14s %14s\n", "phase", "calls", "wall [s]", "cpu [s]");
+  for (int i = 0; i < PHASE_COUNT; ++i) {
+    if (phases[i].calls)
+      fprintf(file, "%-26s %10" PRIu64 " %14.6f %14.6f\n", phase_names[i], phases[i].calls, phases[i].wall, phases[i].cpu);
+  }
+
+  /* Counters of --perf-counters: IPC and misses per calculated digit show, whether a phase is compute or memory bound */
+  if (perf_enabled) {
+    fprintf(file, "\n%-26s %14s %14s %6s %12s %12s %10s %12s %12s\n", "phase counters", "cycles", "instructions", "IPC", 
+      "cache misses", "branch miss.", "page faults", "c.miss/digit", "b.miss/digit");
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+      if (0 == phases[i].calls)
+        continue;
+      fprintf(file, "%-26s", phase_names[i]);
+      for (int c = PERF_CYCLES; c <= PERF_PAGE_FAULTS; ++c) {
+        int width = (c <= PERF_INSTRUCTIONS) ? 14 : (c == PERF_PAGE_FAULTS) ? 10 : 12;
+        if (perf_fds[c] >= 0)
+          fprintf(file, " %*" PRIu64, width, phases[i].counters[c]);
+        else
+          fprintf(file, " %*s", width, "-");
+        if ((PERF_INSTRUCTIONS == c) && (perf_fds[PERF_CYCLES] >= 0) && (perf_fds[c] >= 0) && phases[i].counters[PERF_CYCLES])
+          fprintf(file, " %6.2f", (double)phases[i].counters[c] / phases[i].counters[PERF_CYCLES]);
+        else if (PERF_INSTRUCTIONS == c)
+          fprintf(file, " %6s", "-");
+      }
+      for (int c = PERF_CACHE_MISSES; c <= PERF_BRANCH_MISSES; ++c) {
+        if ((perf_fds[c] >= 0) && stats->digits)
+          fprintf(file, " %12.4f", (double)phases[i].counters[c] / stats->digits);
+        else
+          fprintf(file, " %12s", "-");
+      }
+      fprintf(file, "\n");
+    }
+  }
+
+  fprintf(file, "\n%-26s %10s %14s\n", "routine", "calls", "digits");
+  for (int i = 0; i < OPERATION_COUNT; ++i) {
+    if (operations[i].calls)
+      fprintf(file, "%-26s %10" PRIu64 " %14" PRIu64 "\n", operation_names[i], operations[i].calls, operations[i].digits);
+  }
+
+  /* Karazuba does no digit products itself, all of them are done by the schoolbook tiers */
+  uint64_t total_work = operations[OPERATION_MUL_V0].work + operations[OPERATION_MUL_V1].work;
+  if (total_work) {
+    fprintf(file, "\n%-26s %10s %14s %8s\n", "multiplication tier", "calls", "digit products", "share");
+    fprintf(file, "%-26s %10" PRIu64 " %14" PRIu64 " %7.1f%%\n", "schoolbook", operations[OPERATION_MUL_V0].calls,
+      operations[OPERATION_MUL_V0].work, 100.0 * operations[OPERATION_MUL_V0].work / total_work);
+    fprintf(file, "%-26s %10" PRIu64 " %14" PRIu64 " %7.1f%%\n", "vectorised", operations[OPERATION_MUL_V1].calls,
+      operations[OPERATION_MUL_V1].work, 100.0 * operations[OPERATION_MUL_V1].work / total_work);
+    fprintf(file, "%-26s %10" PRIu64 " %14s\n", "Karazuba (splits)", operations[OPERATION_MUL_KARAZUBA].work +
+      operations[OPERATION_SQR_KARAZUBA].work, "-");
+  }
+#endif
+}
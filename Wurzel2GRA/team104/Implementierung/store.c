@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "headers/store.h"
+
+/* Place 'position' after the point of x (counted from 1), places beyond the mantissa are 0 */
+static uint8_t place(struct bignum x, uint64_t position) {
+  int64_t index = (int64_t)x.exponent - 1 + (int64_t)position; // Index from the most significant digit.
+  if ((index < 0) || (index >= (int64_t)x.mantissa_size))
+    return 0;
+  return x.mantissa[x.mantissa_size - 1 - index];
+}
+
+/*
+  Writes the first 'digits' places after the point of x as result file. The file is written under a temporary name and
+  renamed afterwards, so readers never see a partial file.
+*/
+bool store_write(const char * path, struct bignum x, uint64_t digits) {
+  if ((NULL == x.mantissa) || x.negative || (x.exponent > 19)) {
+    fprintf(stderr, "store_write: Only non-negative values less than 10 ^ 19 can be stored!\n");
+    return false;
+  }
+
+  store_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+  header.format = STORE_FORMAT;
+  header.base = x.base;
+  header.digits = digits;
+  for (int64_t i = 0; i < x.exponent; ++i)
+    header.integer_part = header.integer_part * x.base + ((i < (int64_t)x.mantissa_size) ? x.mantissa[x.mantissa_size - 1 - i] : 0);
+
+  size_t path_length = strlen(path);
+  char * temporary = malloc(path_length + sizeof(".tmp"));
+  if (NULL == temporary) {
+    fprintf(stderr, "store_write: Memory allocation error!\n");
+    return false;
+  }
+  memcpy(temporary, path, path_length);
+  memcpy(temporary + path_length, ".tmp", sizeof(".tmp"));
+
+  FILE * file = fopen(temporary, "wb");
+  if (NULL == file) {
+    fprintf(stderr, "store_write: Error opening file %s for writing!\n", temporary);
+    free(temporary);
+    return false;
+  }
+
+  bool written = (1 == fwrite(&header, sizeof(header), 1, file));
+  uint8_t buffer[4096];
+  size_t used = 0;
+  for (uint64_t position = 1; written && (position <= digits); position += 2) {
+    uint8_t low = (position + 1 <= digits) ? place(x, position + 1) : 0;
+    buffer[used++] = (place(x, position) << 4) | low;
+    if ((used == sizeof(buffer)) || (position + 2 > digits)) {
+      written = (used == fwrite(buffer, 1, used, file));
+      used = 0;
+    }
+  }
+
+  if ((0 != fclose(file)) || !written || (0 != rename(temporary, path))) {
+    fprintf(stderr, "store_write: Error writing file %s!\n", path);
+    remove(temporary);
+    free(temporary);
+    return false;
+  }
+  free(temporary);
+  return true;
+}
+
+bool store_open(store_file_t * file, const char * path) {
+  memset(file, 0, sizeof(*file));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) || !S_ISREG(statbuf.st_mode) || ((size_t)statbuf.st_size < sizeof(store_header_t))) {
+    fprintf(stderr, "store_open: %s is not a valid result file!\n", path);
+    close(fd);
+    return false;
+  }
+
+  void * data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // The mapping stays valid without the file descriptor.
+  if (MAP_FAILED == data)
+    return false;
+
+  memcpy(&file->header, data, sizeof(file->header));
+  file->data = data;
+  file->size = statbuf.st_size;
+
+  /* Checking that the file is a complete result file */
+  store_header_t * header = &file->header;
+  if (memcmp(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) || (header->format != STORE_FORMAT) ||
+      ((header->base != 10) && (header->base != 16)) ||
+      (header->digits / 2 + (header->digits & 1) > file->size - sizeof(*header))) {
+    fprintf(stderr, "store_open: %s is not a valid result file!\n", path);
+    store_close(file);
+    return false;
+  }
+  return true;
+}
+
+void store_close(store_file_t * file) {
+  if (file->data)
+    munmap((void *)file->data, file->size);
+  memset(file, 0, sizeof(*file));
+}
+
+/*
+  Writes the places start .. start + length - 1 after the point (counted from 1) to buffer, terminated with 0.
+  Buffer must hold length + 1 chars. Fails, if the range is not stored in the file.
+*/
+bool store_read(store_file_t * file, uint64_t start, uint64_t length, char * buffer) {
+  if ((0 == start) || (start > file->header.digits) || (length > file->header.digits - start + 1))
+    return false;
+
+  const uint8_t * places = file->data + sizeof(store_header_t);
+  for (uint64_t i = 0; i < length; ++i) {
+    uint64_t position = start - 1 + i; // Index of the place from 0.
+    uint8_t digit = (position & 1) ? (places[position >> 1] & 0xF) : (places[position >> 1] >> 4);
+    buffer[i] = (digit < 10) ? ('0' + digit) : ('A' + digit - 10);
+  }
+  buffer[length] = 0;
+  return true;
+}
@@ -8,6 +8,8 @@
 #include <errno.h>
 
 #include "../headers/bignum.h"
+#include "../headers/add_sub.h"
+#include "../headers/div.h"
 #include "../headers/mul.h"
 #include "../headers/sqrt2.h"
 
@@ -133,6 +135,117 @@ struct test_data_t read_test_data(char * filename) {
   return test_data;
 }
 
+/* Random bignum with 'digits' digits and the given exponent, its first and last digit are not 0 */
+static struct bignum test_random_bignum(size_t digits, uint32_t base, int64_t exponent) {
+  struct bignum x;
+  memset(&x, 0, sizeof(x));
+  x.deallocate = x.mantissa = bignum_calloc(digits, sizeof(x.mantissa[0]));
+  if (NULL == x.mantissa) {
+    fprintf(stderr, "Test: Memory allocation error!\n" "%zu bytes could not be allocated\n", digits);
+    return x;
+  }
+
+  for (size_t i = 0; i < digits; ++i)
+    x.mantissa[i] = rand() % base;
+  x.mantissa[0] = 1 + rand() % (base - 1);
+  x.mantissa[digits - 1] = 1 + rand() % (base - 1);
+  x.mantissa_size = digits;
+  x.exponent = exponent;
+  x.base = base;
+  return x;
+}
+
+/* Sign of a - b: -1, 0 or 1, 2 in case of errors */
+static int test_compare(struct bignum a, struct bignum b) {
+  struct bignum difference = sub_bignum(a, b);
+  int sign = (NULL == difference.mantissa) ? 2 : (((1 == difference.mantissa_size) && (0 == difference.mantissa[0])) ? 0 : 
+    (difference.negative ? -1 : 1));
+  free_bignum(&difference);
+  return sign;
+}
+
+/*
+  Tester for divmod_bignum on random integers: a = q * b + r with 0 <= r < b determines quotient q and remainder r, so
+  the check covers every digit of both. The sizes go through the long division (divisors up to DIV_BASECASE_DIGITS 
+  digits), the limits of its blocks and the recursive division of Burnikel and Ziegler, also for a < b.
+*/
+bool test_divmod(uint32_t base) {
+  static const size_t sizes[][2] = {
+    { 1, 1 }, { 40, 1 }, { 40, 31 }, { 100, 32 }, { 100, 33 }, { 1000, 64 }, { 2048, 1024 }, { 3000, 999 }, 
+    { 5000, 2500 }, { 10000, 3001 }, { 500, 1000 },
+  };
+  srand(base);
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    struct bignum a = test_random_bignum(sizes[i][0], base, sizes[i][0]);
+    struct bignum b = test_random_bignum(sizes[i][1], base, sizes[i][1]);
+    struct bignum remainder;
+    struct bignum quotient = divmod_bignum(a, b, &remainder);
+    struct bignum product = mul_bignum_karazuba(quotient, b);
+    struct bignum sum = add_bignum(product, remainder);
+    struct bignum zero = bignum_uint64(0, base);
+
+    bool passed = (NULL != quotient.mantissa) && (NULL != remainder.mantissa) && (0 == test_compare(sum, a)) &&
+      (test_compare(remainder, zero) >= 0) && (-1 == test_compare(remainder, b));
+
+    free_bignum(&zero);
+    free_bignum(&sum);
+    free_bignum(&product);
+    free_bignum(&quotient);
+    free_bignum(&remainder);
+    free_bignum(&b);
+    free_bignum(&a);
+    if (!passed) {
+      fprintf(stderr, "Test of divmod_bignum failed for %zu / %zu digits in base %u!\n", sizes[i][0], sizes[i][1], base);
+      return false;
+    }
+  }
+  printf("Test of divmod_bignum in base %u worked!\n", base);
+  return true;
+}
+
+/* 
+  Tester for the warm start of the Newton–Raphson division, that sqrt2_V2 uses: a division by b leaves its reciprocal,
+  the following division by b2, that differs from b after about half of its places, starts with it. Both quotients are
+  compared with the exact division, they may only differ in the last places. div_bignum_newton is used, because 
+  div_bignum_reciprocal divides exactly below DIV_EXACT_MAX_DIGITS digits, which would take minutes per test.
+*/
+bool test_reciprocal(uint32_t base) {
+  const size_t n = 3000;
+  srand(base + 1);
+  struct bignum a = test_random_bignum(n, base, 1);
+  struct bignum b = test_random_bignum(n, base, 0);
+  struct bignum b2 = copy_bignum(b, b.mantissa_size);
+  if (b2.mantissa)
+    b2.mantissa[n / 2] = (b2.mantissa[n / 2] + 1) % base;
+  struct bignum reciprocal;
+  memset(&reciprocal, 0, sizeof(reciprocal));
+
+  bool passed = (NULL != a.mantissa) && (NULL != b.mantissa) && (NULL != b2.mantissa);
+  struct bignum divisors[] = { b, b2 };
+  for (int i = 0; passed && (i < 2); ++i) {
+    struct bignum quotient = div_bignum_newton(a, divisors[i], n, &reciprocal);
+    struct bignum exact = div_bignum(a, divisors[i], n);
+    struct bignum difference = sub_bignum(quotient, exact);
+    passed = (NULL != reciprocal.mantissa) && (NULL != quotient.mantissa) && (NULL != exact.mantissa) && 
+      (NULL != difference.mantissa) && (((1 == difference.mantissa_size) && (0 == difference.mantissa[0])) || 
+      (difference.exponent <= exact.exponent - (int64_t)n + 2));
+    free_bignum(&difference);
+    free_bignum(&exact);
+    free_bignum(&quotient);
+  }
+
+  free_bignum(&reciprocal);
+  free_bignum(&b2);
+  free_bignum(&b);
+  free_bignum(&a);
+  if (!passed) {
+    fprintf(stderr, "Test of the Newton–Raphson division with known reciprocal failed in base %u!\n", base);
+    return false;
+  }
+  printf("Test of the Newton–Raphson division with known reciprocal in base %u worked!\n", base);
+  return true;
+}
+
 /* 
   Tester for the root of 2 function in required numeral system with parameters from 50 to 75000000 (for future optimisations).
   Retrieves pre-calculated values from the appropriate file, compares them with the results of our calculations and measures, if 
@@ -172,6 +285,9 @@ bool test(config_t config) {
     printf("\n");
   }
 
+  if (!test_divmod((config.numeral_system == DECIMAL) ? 10 : 16) || !test_reciprocal((config.numeral_system == DECIMAL) ? 10 : 16))
+    return false;
+
   struct test_data_t test_data = read_test_data(filename);
   if (test_data.test_count == 0)
     return false;
@@ -182,7 +298,7 @@ bool test(config_t config) {
 
     config.digits = test_data.test_length[t];
     int i;
-    double time;
+    double time = 0;
 
     if (config.show_time) {
       printf("Testing %d digits...\n", test_data.test_length[t]);
@@ -220,6 +336,10 @@ bool test(config_t config) {
         case VERSION_2:
           current_sqrt = sqrt2_V2;
           break; 
+
+        case VERSION_3:
+          current_sqrt = sqrt2_V3;
+          break;
       }
 
       struct timespec start;
@@ -270,10 +390,20 @@ bool test(config_t config) {
         case VERSION_2:
           sqrt2_value = sqrt2_V2(config.digits, config.numeral_system);
           break;
+
+        case VERSION_3:
+          sqrt2_value = sqrt2_V3(config.digits, config.numeral_system);
+          break;
       }
     }
 
-    char * actual = build_string(sqrt2_value, test_data.test_count);
+    if (NULL == sqrt2_value.mantissa) {
+      fprintf(stderr, "Test: Calculation of %d %s digits failed!\n", test_data.test_length[t], numeral_system_string);
+      cleanup_test_data(&test_data);
+      return false;
+    }
+
+    char * actual = build_string(sqrt2_value, test_data.test_length[t]);
 
     /* Testing if mismatch between actual and expected occured */
     for (i = 0; i < 50; ++i) {
@@ -300,6 +430,10 @@ bool test(config_t config) {
       case VERSION_2:
         version = ("VERSION_2");
         break;
+
+      case VERSION_3:
+        version = ("VERSION_3");
+        break;
     }
 
     if (config.show_time) {
@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "headers/wurzel.h"
+
+/* Context for calls outside of the library API, e.g. from the benchmarks. Single-threaded */
+static wurzel_context_t default_context = {
+  .threads = 1,
+  .huge_pages = HUGE_PAGES_TRANSPARENT,
+};
+
+/* Current context of each thread, set by the library API and by the workers of a thread pool */
+static _Thread_local wurzel_context_t * current_context = NULL;
+
+wurzel_context_t * context_current(void) {
+  return current_context ? current_context : &default_context;
+}
+
+wurzel_context_t * context_enter(wurzel_context_t * context) {
+  wurzel_context_t * previous = current_context;
+  current_context = context;
+  return previous;
+}
+
+void context_leave(wurzel_context_t * previous) {
+  current_context = previous;
+}
+
+wurzel_context_t * wurzel_context_create(int threads) {
+  wurzel_context_t * context = calloc(1, sizeof(*context));
+  if (NULL == context) {
+    fprintf(stderr, "wurzel_context_create: Memory allocation error!\n");
+    return NULL;
+  }
+
+  context->huge_pages = HUGE_PAGES_TRANSPARENT;
+  context->threads = (threads < 1) ? 1 : threads;
+  if (context->threads > 1) {
+    context->pool = pool_create(context, context->threads - 1);
+    if (NULL == context->pool) {
+      free(context);
+      return NULL;
+    }
+  }
+  return context;
+}
+
+void wurzel_context_destroy(wurzel_context_t * context) {
+  if (NULL == context)
+    return;
+  wurzel_cache_clear(context);
+  pool_destroy(context->pool);
+  free(context);
+}
+
+void wurzel_cache_clear(wurzel_context_t * context) {
+  for (int i = 0; i <= HEXADECIMAL; ++i) {
+    free_bignum(&context->cache[i].value);
+    memset(&context->cache[i], 0, sizeof(context->cache[i]));
+  }
+  for (int i = 0; i < SUM_PQ_STATES; ++i)
+    sum_pq_state_clear(&context->splitting_state[i]);
+}
+
+/* 
+  Calculates root of 2 with at least 'digits' places with the given version in the given context.
+  If cache_results is set, a request with at most as many places as the cached result of the numeral system is served by
+  a copy of the cached result, that is cut off after 'digits' places. All versions calculate at least 'digits' correct
+  places, so the cut off copy prints the same digits as a new calculation. Larger requests are calculated and replace
+  the cached result.
+*/
+struct bignum wurzel_sqrt2(wurzel_context_t * context, size_t digits, numeral_system_t base, version_t version) {
+  wurzel_context_t * previous = context_enter(context);
+  struct bignum result;
+  memset(&result, 0, sizeof(result));
+
+  wurzel_cache_entry_t * entry = &context->cache[base];
+  if (context->cache_results && entry->value.mantissa && (digits <= entry->digits)) {
+    ++context->cache_hits;
+    result = copy_bignum(entry->value, entry->value.exponent + digits); // Integer part and 'digits' places.
+    context_leave(previous);
+    return result;
+  }
+
+  if (digits > context->stats.digits)
+    context->stats.digits = digits;
+  switch (version) {
+    case VERSION_0:
+      result = sqrt2(digits, base);
+      break;
+    
+    case VERSION_1:
+      result = sqrt2_V1(digits, base);
+      break;
+
+    case VERSION_2:
+      result = sqrt2_V2(digits, base);
+      break;
+
+    case VERSION_3:
+      result = sqrt2_V3(digits, base);
+      break;
+  }
+
+  if (context->cache_results && result.mantissa) {
+    ++context->cache_misses;
+    free_bignum(&entry->value);
+    entry->value = copy_bignum(result, result.mantissa_size);
+    entry->digits = entry->value.mantissa ? digits : 0;
+  }
+
+  context_leave(previous);
+  return result;
+}
+
+bool wurzel_verify(wurzel_context_t * context, struct bignum x, size_t digits) {
+  wurzel_context_t * previous = context_enter(context);
+  bool verified = verify_sqrt2(x, digits);
+  context_leave(previous);
+  return verified;
+}
+
+/* String representation of x with exactly 'digits' places after the point (the rest is cut off) */
+char * wurzel_format(wurzel_context_t * context, struct bignum x, size_t digits) {
+  wurzel_context_t * previous = context_enter(context);
+  STATS_PHASE_BEGIN(PHASE_BUILD_STRING);
+  char * result = build_string(x, digits);
+  STATS_PHASE_END(PHASE_BUILD_STRING);
+  context_leave(previous);
+
+  if (NULL == result)
+    return NULL;
+
+  /* Without places the point is cut off, build_string already stops after 'digits' places */
+  char * point = strchr(result, '.');
+  if (point && (digits == 0))
+    point[0] = 0;
+  return result;
+}
+
+/*
+  Root of 2 in the numeral systems bases[i] with digits[i] places each (results[i], strings like from wurzel_format).
+  Root of 2 is calculated once in base 16 with enough places for all results and then converted (see radix_convert),
+  powers of 2 only need their bits regrouped. If a conversion is not certain, the calculation is extended by some 
+  places and the remaining results are converted again. Returns false in case of errors, results are NULL then.
+*/
+bool wurzel_sqrt2_bases(wurzel_context_t * context, size_t count, const uint32_t * bases, const size_t * digits, 
+    version_t version, char ** results) {
+  size_t places = 0;
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = NULL;
+    if ((bases[i] < 2) || (bases[i] > RADIX_MAX_BASE)) {
+      fprintf(stderr, "wurzel_sqrt2_bases: Invalid numeral system %u!\n", bases[i]);
+      return false;
+    }
+
+    /* digits * log16(base) places of base 16 carry the same information, 4 more are guard places */
+    size_t required = (size_t)(digits[i] * (log2(bases[i]) / 4.0)) + 4;
+    if (required > places)
+      places = required;
+  }
+
+  wurzel_context_t * previous = context_enter(context);
+  bool success = true;
+  size_t remaining = count;
+  while (success && remaining) {
+    struct bignum x = wurzel_sqrt2(context, places, HEXADECIMAL, version);
+    success = (NULL != x.mantissa);
+
+    for (size_t i = 0; success && (i < count); ++i) {
+      if (results[i])
+        continue;
+
+      bool certain = true;
+      struct bignum converted = radix_convert(x, places, bases[i], digits[i], &certain);
+      if (certain) {
+        results[i] = converted.mantissa ? wurzel_format(context, converted, digits[i]) : NULL;
+        success = (NULL != results[i]);
+        --remaining;
+      }
+      free_bignum(&converted);
+    }
+    free_bignum(&x);
+    places += (places >> 3) + 16;
+  }
+  context_leave(previous);
+
+  if (!success) {
+    for (size_t i = 0; i < count; ++i) {
+      free(results[i]);
+      results[i] = NULL;
+    }
+  }
+  return success;
+}
+
+/*
+  Places start .. start + length - 1 after the point of root of 2 (counted from 1) from the result file 'path'. 
+  Only if the file is missing or does not contain the range, root of 2 is calculated up to the last requested place 
+  and the file is replaced. Files of the other numeral system and other files are never replaced. Returns a string of 'length' places, NULL in case of errors.
+*/
+char * wurzel_range(wurzel_context_t * context, const char * path, numeral_system_t base, version_t version, 
+    uint64_t start, uint64_t length) {
+  uint32_t numeral_system_base = (base == DECIMAL) ? 10 : 0x10;
+  if ((0 == start) || (length > UINT64_MAX - start)) {
+    fprintf(stderr, "wurzel_range: Invalid range %" PRIu64 ":%" PRIu64 "!\n", start, length);
+    return NULL;
+  }
+
+  char * result = malloc(length + 1);
+  if (NULL == result) {
+    fprintf(stderr, "wurzel_range: Memory allocation error!\n");
+    return NULL;
+  }
+
+  store_file_t file;
+  bool stored = store_open(&file, path);
+  if (!stored && (0 == access(path, F_OK))) { // Other files are never replaced.
+    free(result);
+    return NULL;
+  }
+  if (stored && (file.header.base != numeral_system_base)) { // Results of the other numeral system are kept as well.
+    fprintf(stderr, "wurzel_range: %s is a result file of numeral system %" PRIu32 ", not %" PRIu32 "!\n", path, 
+      file.header.base, numeral_system_base);
+    store_close(&file);
+    free(result);
+    return NULL;
+  }
+  if (stored && store_read(&file, start, length, result)) {
+    store_close(&file);
+    return result;
+  }
+
+  /* The range is not stored: calculation up to its end, but never less than stored before */
+  uint64_t digits = start + length - 1;
+  if (stored && (file.header.digits > digits))
+    digits = file.header.digits;
+  store_close(&file);
+
+  struct bignum x = wurzel_sqrt2(context, digits, base, version);
+  if ((NULL == x.mantissa) || !store_write(path, x, digits) || !store_open(&file, path) || 
+      !store_read(&file, start, length, result)) {
+    store_close(&file);
+    free_bignum(&x);
+    free(result);
+    return NULL;
+  }
+  store_close(&file);
+  free_bignum(&x);
+  return result;
+}
+
+void wurzel_report(wurzel_context_t * context, FILE * file) {
+  stats_report(&context->stats, file);
+  if (context->cache_hits || context->cache_misses)
+    fprintf(file, "\nResult cache: %" PRIu64 " hits, %" PRIu64 " misses\n", context->cache_hits, context->cache_misses);
+  fprintf(file, "\nMemory of bignums: %zu bytes peak, %zu bytes still in use\n", context->memory_peak, context->memory_current);
+}